@@ -15,14 +15,22 @@
  */
 
 #include <cerrno>
-#include <set>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
 #include <vector>
 
+#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/properties.h>
+#include <android-base/stringprintf.h>
 #include <hidl/HidlTransportSupport.h>
+#include <utils/SystemClock.h>
 
 #include "Thermal.h"
 #include "thermal-helper.h"
+#include "thermal-telemetry.h"
 
 namespace android {
 namespace hardware {
@@ -31,55 +39,95 @@ namespace V2_0 {
 namespace implementation {
 
 using ::android::sp;
-using ::android::hardware::interfacesEqual;
+using ::android::base::GetProperty;
+using ::android::base::StringAppendF;
+using ::android::base::WriteStringToFd;
 using ::android::hardware::thermal::V1_0::ThermalStatus;
 using ::android::hardware::thermal::V1_0::ThermalStatusCode;
 
-std::set<sp<IThermalChangedCallback>> gCallbacks;
+// Number of last journal records dumped by debug() without argument
+constexpr size_t kJournalDumpRecords = 32;
+
+// Trace of sensor reads recorded on debug() request
+constexpr const char *kTraceFile = "/data/vendor/thermal/trace.bin";
+
+// Delays between two discovery attempts
+constexpr std::chrono::milliseconds kDiscoveryRetryMin(100);
+constexpr std::chrono::milliseconds kDiscoveryRetryMax(10000);
+
+Thermal::Thermal()
+    : emergency_handler_(std::bind(&Thermal::notifyThrottling, this, std::placeholders::_1)),
+      monitor_stop_(false),
+      rescan_pending_(false),
+      reload_pending_(false),
+      telemetry_lease_(0),
+      headroom_lease_(0),
+      uevent_listener_(std::bind(&Thermal::requestRescan, this)) {
+    // Telemetry region must exist before the first sample
+    if (!initTelemetry()) {
+        LOG(WARNING) << "Telemetry shared memory not supported";
+    }
+    if (!initJournal()) {
+        LOG(WARNING) << "Thermal event journal not available";
+    }
+    // Metrics endpoint is optional, enabled by setting its socket path
+    std::string metrics_socket = GetProperty(kMetricsSocketProperty, "");
+    if (!metrics_socket.empty() && !metrics_server_.start(metrics_socket)) {
+        LOG(WARNING) << "Metrics endpoint not available";
+    }
+    // Emergency path checks every sample, whoever triggers it
+    emergency_handler_.start();
+    setSampleListener(std::bind(&EmergencyHandler::check, &emergency_handler_, std::placeholders::_1));
+    if (!scheduler_.init()) {
+        LOG(WARNING) << "Sampling timer not available, waits bounded by polling";
+    }
+    // Discovery is done by the monitor thread, so that service registration is not delayed
+    monitor_thread_ = std::thread(&Thermal::monitorLoop, this);
+    if (!uevent_listener_.start()) {
+        LOG(WARNING) << "Thermal zones and cooling devices hotplug not supported";
+    }
+}
 
-Thermal::Thermal() : enabled_(initThermal()) {}
+Thermal::~Thermal() {
+    {
+        std::lock_guard<std::mutex> _lock(monitor_mutex_);
+        monitor_stop_ = true;
+    }
+    scheduler_.wake();
+    if (monitor_thread_.joinable()) {
+        monitor_thread_.join();
+    }
+    setSampleListener(nullptr);
+    syncJournal();
+}
 
 // Methods from ::android::hardware::thermal::V1_0::IThermal follow.
 
 Return<void> Thermal::getTemperatures(getTemperatures_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_TEMPERATURES));
     ThermalStatus status;
     status.code = ThermalStatusCode::SUCCESS;
 
-    std::vector<Temperature_1_0> temperatures;
-    temperatures.resize(kTemperatureNum);
+    hidl_vec<Temperature_1_0> temperatures;
 
-    if (!enabled_) {
-        status.code = ThermalStatusCode::FAILURE;
-        status.debugMessage = "Unsupported hardware";
-        _hidl_cb(status, temperatures);
-        return Void();
-    }
-
-    ssize_t ret = fillTemperatures_1_0(&temperatures);
+    ssize_t ret = fillTemperatures(*getSnapshot(), false, TemperatureType::UNKNOWN, &temperatures);
     if (ret == 0) {
         status.code = ThermalStatusCode::FAILURE;
         status.debugMessage = "No available sensor";
     }
-    temperatures.resize(ret);
 
     _hidl_cb(status, temperatures);
     return Void();
 }
 
 Return<void> Thermal::getCpuUsages(getCpuUsages_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_CPU_USAGES));
     ThermalStatus status;
     status.code = ThermalStatusCode::SUCCESS;
 
     std::vector<CpuUsage> cpuUsages;
     cpuUsages.resize(kCpuNum);
 
-    if (!enabled_) {
-        status.code = ThermalStatusCode::FAILURE;
-        status.debugMessage = "Unsupported hardware";
-        _hidl_cb(status, cpuUsages);
-        return Void();
-    }
-
     ssize_t ret = fillCpuUsages(&cpuUsages);
     if (ret < 0) {
         status.code = ThermalStatusCode::FAILURE;
@@ -91,25 +139,17 @@ Return<void> Thermal::getCpuUsages(getCpuUsages_cb _hidl_cb) {
 }
 
 Return<void> Thermal::getCoolingDevices(getCoolingDevices_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_COOLING_DEVICES));
     ThermalStatus status;
     status.code = ThermalStatusCode::SUCCESS;
 
-    std::vector<CoolingDevice_1_0> coolingDevices;
-    coolingDevices.resize(1);
+    hidl_vec<CoolingDevice_1_0> coolingDevices;
 
-    if (!enabled_) {
-        status.code = ThermalStatusCode::FAILURE;
-        status.debugMessage = "Unsupported hardware";
-        _hidl_cb(status, coolingDevices);
-        return Void();
-    }
-
-    ssize_t ret = fillCoolingDevices_1_0(&coolingDevices);
+    ssize_t ret = fillCoolingDevices(*getSnapshot(), false, CoolingType_2_0::FAN, &coolingDevices);
     if (ret == 0) {
         status.code = ThermalStatusCode::FAILURE;
         status.debugMessage = "No available cooling device";
     }
-    coolingDevices.resize(ret);
 
     _hidl_cb(status, coolingDevices);
     return Void();
@@ -119,30 +159,17 @@ Return<void> Thermal::getCoolingDevices(getCoolingDevices_cb _hidl_cb) {
 
 Return<void> Thermal::getCurrentTemperatures(bool filterType, TemperatureType type,
                                              getCurrentTemperatures_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_CURRENT_TEMPERATURES));
     ThermalStatus status;
     status.code = ThermalStatusCode::SUCCESS;
 
-    std::vector<Temperature_2_0> temperatures;
-    temperatures.resize(kTemperatureNum);
-
-    if (!enabled_) {
-        status.code = ThermalStatusCode::FAILURE;
-        status.debugMessage = "Unsupported hardware";
-        _hidl_cb(status, temperatures);
-        return Void();
-    }
+    hidl_vec<Temperature_2_0> temperatures;
 
-    ssize_t ret;
-    if (filterType) {
-        ret = fillTemperature_2_0(&temperatures, type);
-    } else {
-        ret = fillTemperatures_2_0(&temperatures);
-    }
+    ssize_t ret = fillTemperatures(*getSnapshot(), filterType, type, &temperatures);
     if (ret == 0) {
         status.code = ThermalStatusCode::FAILURE;
         status.debugMessage = "No available sensor";
     }
-    temperatures.resize(ret);
 
     _hidl_cb(status, temperatures);
     return Void();
@@ -150,30 +177,18 @@ Return<void> Thermal::getCurrentTemperatures(bool filterType, TemperatureType ty
 
 Return<void> Thermal::getTemperatureThresholds(bool filterType, TemperatureType type,
                                                getTemperatureThresholds_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_TEMPERATURE_THRESHOLDS));
     ThermalStatus status;
     status.code = ThermalStatusCode::SUCCESS;
 
-    std::vector<TemperatureThreshold> temperatureThresholds;
-    temperatureThresholds.resize(kTemperatureNum);
-
-    if (!enabled_) {
-        status.code = ThermalStatusCode::FAILURE;
-        status.debugMessage = "Unsupported hardware";
-        _hidl_cb(status, temperatureThresholds);
-        return Void();
-    }
-
-    ssize_t ret;
-    if (filterType) {
-        ret = fillTemperatureThreshold(&temperatureThresholds, type);
-    } else {
-        ret = fillTemperaturesThreshold(&temperatureThresholds);
-    }
-    if (ret == 0) {
+    // Table is immutable: thresholds are handed out without any copy
+    std::shared_ptr<const threshold_table_t> table = getThresholdTable();
+    const hidl_vec<TemperatureThreshold> &temperatureThresholds =
+        filterType ? getTypeThreshold(*table, type) : table->all;
+    if (temperatureThresholds.size() == 0) {
         status.code = ThermalStatusCode::FAILURE;
         status.debugMessage = "No available sensor";
     }
-    temperatureThresholds.resize(ret);
 
     _hidl_cb(status, temperatureThresholds);
     return Void();
@@ -181,30 +196,17 @@ Return<void> Thermal::getTemperatureThresholds(bool filterType, TemperatureType
 
 Return<void> Thermal::getCurrentCoolingDevices(bool filterType, CoolingType_2_0 type,
                                                getCurrentCoolingDevices_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_CURRENT_COOLING_DEVICES));
     ThermalStatus status;
     status.code = ThermalStatusCode::SUCCESS;
 
-    std::vector<CoolingDevice_2_0> coolingDevices;
-    coolingDevices.resize(kCoolingNum_2_0);
-
-    if (!enabled_) {
-        status.code = ThermalStatusCode::FAILURE;
-        status.debugMessage = "Unsupported hardware";
-        _hidl_cb(status, coolingDevices);
-        return Void();
-    }
+    hidl_vec<CoolingDevice_2_0> coolingDevices;
 
-    ssize_t ret;
-    if (filterType) {
-        ret = fillCoolingDevice_2_0(&coolingDevices, type);
-    } else {
-        ret = fillCoolingDevices_2_0(&coolingDevices);
-    }
+    ssize_t ret = fillCoolingDevices(*getSnapshot(), filterType, type, &coolingDevices);
     if (ret == 0) {
         status.code = ThermalStatusCode::FAILURE;
         status.debugMessage = "No available cooling device";
     }
-    coolingDevices.resize(ret);
 
     _hidl_cb(status, coolingDevices);
     return Void();
@@ -213,6 +215,7 @@ Return<void> Thermal::getCurrentCoolingDevices(bool filterType, CoolingType_2_0
 Return<void> Thermal::registerThermalChangedCallback(const sp<IThermalChangedCallback>& callback,
                                                      bool filterType, TemperatureType type,
                                                      registerThermalChangedCallback_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::REGISTER_THERMAL_CHANGED_CALLBACK));
     ThermalStatus status;
     if (callback == nullptr) {
         status.code = ThermalStatusCode::FAILURE;
@@ -223,15 +226,11 @@ Return<void> Thermal::registerThermalChangedCallback(const sp<IThermalChangedCal
     } else {
         status.code = ThermalStatusCode::SUCCESS;
     }
-    std::lock_guard<std::mutex> _lock(thermal_callback_mutex_);
-    if (std::any_of(callbacks_.begin(), callbacks_.end(), [&](const CallbackSetting& c) {
-            return interfacesEqual(c.callback, callback);
-        })) {
+    if (!addThrottlingCallback(callback, filterType, type)) {
         status.code = ThermalStatusCode::FAILURE;
         status.debugMessage = "Same callback interface registered already";
         LOG(ERROR) << status.debugMessage;
     } else {
-        callbacks_.emplace_back(callback, filterType, type);
         LOG(INFO) << "A callback has been registered to ThermalHAL, isFilter: " << filterType
                   << " Type: " << android::hardware::thermal::V2_0::toString(type);
     }
@@ -241,6 +240,7 @@ Return<void> Thermal::registerThermalChangedCallback(const sp<IThermalChangedCal
 
 Return<void> Thermal::unregisterThermalChangedCallback(
     const sp<IThermalChangedCallback>& callback, unregisterThermalChangedCallback_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::UNREGISTER_THERMAL_CHANGED_CALLBACK));
     ThermalStatus status;
     if (callback == nullptr) {
         status.code = ThermalStatusCode::FAILURE;
@@ -251,23 +251,12 @@ Return<void> Thermal::unregisterThermalChangedCallback(
     } else {
         status.code = ThermalStatusCode::SUCCESS;
     }
-    bool removed = false;
-    std::lock_guard<std::mutex> _lock(thermal_callback_mutex_);
-    callbacks_.erase(
-        std::remove_if(callbacks_.begin(), callbacks_.end(),
-                       [&](const CallbackSetting& c) {
-                           if (interfacesEqual(c.callback, callback)) {
-                               LOG(INFO)
-                                   << "A callback has been unregistered from ThermalHAL, isFilter: "
-                                   << c.is_filter_type << " Type: "
-                                   << android::hardware::thermal::V2_0::toString(c.type);
-                               removed = true;
-                               return true;
-                           }
-                           return false;
-                       }),
-        callbacks_.end());
-    if (!removed) {
+    bool is_filter_type;
+    TemperatureType type;
+    if (removeThrottlingCallback(callback, &is_filter_type, &type)) {
+        LOG(INFO) << "A callback has been unregistered from ThermalHAL, isFilter: " << is_filter_type
+                  << " Type: " << android::hardware::thermal::V2_0::toString(type);
+    } else {
         status.code = ThermalStatusCode::FAILURE;
         status.debugMessage = "The callback was not registered before";
         LOG(ERROR) << status.debugMessage;
@@ -276,28 +265,530 @@ Return<void> Thermal::unregisterThermalChangedCallback(
     return Void();
 }
 
+// Methods from ::vendor::stm32mpu::hardware::thermal::V1_0::IThermalExt follow.
+
+Return<void> Thermal::getTelemetryMemory(getTelemetryMemory_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_TELEMETRY_MEMORY));
+    ThermalStatus status;
+    status.code = ThermalStatusCode::SUCCESS;
+
+    hidl_memory telemetry;
+
+    if (!fillTelemetryMemory(&telemetry)) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "Telemetry not available";
+    } else {
+        // Reads of the region cannot be tracked: sampling stays on until the lease expires
+        renewLease(&telemetry_lease_);
+    }
+
+    _hidl_cb(status, telemetry);
+    return Void();
+}
+
+Return<void> Thermal::getThermalState(bool filterTemperatureType, TemperatureType temperatureType,
+                                      bool filterCoolingType, CoolingType_2_0 coolingType,
+                                      getThermalState_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_THERMAL_STATE));
+    ThermalStatus status;
+    status.code = ThermalStatusCode::SUCCESS;
+
+    ThermalState state;
+    std::vector<CpuUsage> cpuUsages;
+    cpuUsages.resize(kCpuNum);
+
+    // Temperatures, thresholds and cooling devices come from the same sample
+    std::shared_ptr<const thermal_snapshot_t> snapshot = getSnapshot();
+    state.timestamp = snapshot->timestamp;
+    fillTemperatures(*snapshot, filterTemperatureType, temperatureType, &state.temperatures);
+    fillTemperatures(*snapshot, filterTemperatureType, temperatureType, &state.rawTemperatures);
+    fillTemperatureThresholds(*snapshot, filterTemperatureType, temperatureType, &state.temperatureThresholds);
+    fillCoolingDevices(*snapshot, filterCoolingType, coolingType, &state.coolingDevices);
+
+    ssize_t ret = fillCpuUsages(&cpuUsages);
+    if (ret < 0) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = strerror(-ret);
+    } else {
+        state.cpuUsages = cpuUsages;
+    }
+
+    _hidl_cb(status, state);
+    return Void();
+}
+
+Return<void> Thermal::registerThresholdCallback(const sp<IThermalThresholdCallback>& callback,
+                                                const hidl_string& name, float threshold, float hysteresis,
+                                                registerThresholdCallback_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::REGISTER_THRESHOLD_CALLBACK));
+    ThermalStatus status;
+    status.code = ThermalStatusCode::SUCCESS;
+
+    uint32_t id = 0;
+    float value = NAN;
+
+    if (callback == nullptr) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "Invalid nullptr callback";
+    } else if (!std::isfinite(threshold) || !std::isfinite(hysteresis) || hysteresis < 0) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "Invalid threshold or hysteresis";
+    } else {
+        // Initial direction is based on last temperature read
+        std::shared_ptr<const thermal_snapshot_t> snapshot = getSnapshot();
+        bool found = false;
+        for (int k=0; k < snapshot->config->nb_sensor; k++) {
+            found |= (strcmp(snapshot->config->sensor[k].name, name.c_str()) == 0);
+        }
+        for (int i=0; i < snapshot->nb_temperature; i++) {
+            const temperature_sample_t &sample = snapshot->temperature[i];
+            if (strcmp(snapshot->config->sensor[sample.name].name, name.c_str()) == 0) {
+                value = sample.value;
+            }
+        }
+
+        if (!found) {
+            status.code = ThermalStatusCode::FAILURE;
+            status.debugMessage = "Unknown sensor";
+        } else if (!threshold_registry_.add(callback, name, threshold, hysteresis, value, &id)) {
+            status.code = ThermalStatusCode::FAILURE;
+            status.debugMessage = "Too many threshold subscriptions";
+        } else {
+            LOG(INFO) << "Threshold " << threshold << " (hysteresis " << hysteresis << ") on " << name
+                      << " registered, id " << id;
+            scheduler_.wake();
+        }
+    }
+    if (status.code != ThermalStatusCode::SUCCESS) {
+        LOG(ERROR) << status.debugMessage;
+    }
+
+    _hidl_cb(status, id);
+    return Void();
+}
+
+Return<void> Thermal::unregisterThresholdCallback(const sp<IThermalThresholdCallback>& callback, uint32_t id,
+                                                  unregisterThresholdCallback_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::UNREGISTER_THRESHOLD_CALLBACK));
+    ThermalStatus status;
+    status.code = ThermalStatusCode::SUCCESS;
+
+    if (callback == nullptr) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "Invalid nullptr callback";
+        LOG(ERROR) << status.debugMessage;
+    } else if (!threshold_registry_.remove(callback, id)) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "The threshold was not registered before";
+        LOG(ERROR) << status.debugMessage;
+    }
+
+    _hidl_cb(status);
+    return Void();
+}
+
+Return<void> Thermal::getTemperatureStats(bool filterType, TemperatureType type,
+                                          getTemperatureStats_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_TEMPERATURE_STATS));
+    ThermalStatus status;
+    status.code = ThermalStatusCode::SUCCESS;
+
+    hidl_vec<TemperatureStats> stats;
+
+    stats_collector_.getStats(filterType, type, &stats);
+    if (stats.size() == 0) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "No available sensor";
+    }
+
+    _hidl_cb(status, stats);
+    return Void();
+}
+
+Return<void> Thermal::getCoolingResidency(getCoolingResidency_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_COOLING_RESIDENCY));
+    ThermalStatus status;
+    status.code = ThermalStatusCode::SUCCESS;
+
+    hidl_vec<CoolingResidency> residencies;
+
+    residency_collector_.getResidency(&residencies);
+    if (residencies.size() == 0) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "No available cooling device";
+    }
+
+    _hidl_cb(status, residencies);
+    return Void();
+}
+
+Return<void> Thermal::getTemperatureHeadroom(bool filterType, TemperatureType type, uint32_t forecastMs,
+                                             getTemperatureHeadroom_cb _hidl_cb) {
+    ScopedLatency _latency(metrics_server_.getLatency(MetricsMethod::GET_TEMPERATURE_HEADROOM));
+    ThermalStatus status;
+    status.code = ThermalStatusCode::SUCCESS;
+
+    hidl_vec<TemperatureHeadroom> headrooms;
+
+    // Clients poll at frame rate, without notice when they stop: each call renews the lease
+    renewLease(&headroom_lease_);
+    if (!headroom_estimator_.getHeadroom(filterType, type, forecastMs, &headrooms)) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "No sample yet";
+    } else if (headrooms.size() == 0) {
+        status.code = ThermalStatusCode::FAILURE;
+        status.debugMessage = "No available sensor";
+    }
+
+    _hidl_cb(status, headrooms);
+    return Void();
+}
+
+// Methods from ::android::hidl::base::V1_0::IBase follow.
+
+Return<void> Thermal::debug(const hidl_handle& handle, const hidl_vec<hidl_string>& args) {
+    if (handle == nullptr || handle->numFds < 1) {
+        LOG(ERROR) << "debug: invalid file descriptor";
+        return Void();
+    }
+    int fd = handle->data[0];
+    std::string dump;
+
+    if (args.size() == 1 && strcmp(args[0].c_str(), "--reload") == 0) {
+        // Checked here too, so that a rejected file is reported to the caller
+        std::string config_path = getThermalConfigPath();
+        if (BoardProfile::kRuntimeConfig && parseThermalConfig(config_path) == nullptr) {
+            StringAppendF(&dump, "Invalid configuration %s, current configuration kept\n", config_path.c_str());
+        } else {
+            requestReload();
+            StringAppendF(&dump, "Configuration reload requested from %s\n", config_path.c_str());
+        }
+    } else if (args.size() == 1 && strcmp(args[0].c_str(), "--journal") == 0) {
+        dumpJournal(kJournalCapacity, &dump);
+    } else if (args.size() == 1 && strcmp(args[0].c_str(), "--record") == 0) {
+        if (startThermalRecord(kTraceFile)) {
+            StringAppendF(&dump, "Recording sensor reads to %s\n", kTraceFile);
+        } else {
+            StringAppendF(&dump, "Failed to record to %s (already recording?)\n", kTraceFile);
+        }
+    } else if (args.size() == 1 && strcmp(args[0].c_str(), "--record-stop") == 0) {
+        ssize_t count = stopThermalRecord();
+        if (count >= 0) {
+            StringAppendF(&dump, "Recorded %zd sensor reads to %s\n", count, kTraceFile);
+        } else {
+            dump = "Not recording\n";
+        }
+    } else if (args.size() > 0) {
+        dump = "Usage: lshal debug android.hardware.thermal@2.0::IThermal/default"
+               " [--reload | --journal | --record | --record-stop]\n";
+    } else {
+        std::shared_ptr<const thermal_config_t> config = getThermalConfig();
+        StringAppendF(&dump, "Polling period: %" PRId64 " ms\n", config->polling_period_ns / 1000000);
+        sampling_demand_t demand = getDemand();
+        StringAppendF(&dump, "Sampling %s: %zu callbacks, %zu subscriptions, %zu telemetry, %zu headroom, "
+                      "%zu actuators\n", demand.total() > 0 ? "active" : "stopped", demand.callbacks,
+                      demand.subscriptions, demand.telemetry, demand.headroom, demand.actuators);
+        for (int k=0; k < config->nb_sensor; k++) {
+            const sensor_config_t &sensor = config->sensor[k];
+            StringAppendF(&dump, "Sensor %s: type %d, %s%s, filter %d\n", sensor.name,
+                          static_cast<int>(sensor.type), sensor.is_virtual ? "virtual" : "zone ",
+                          sensor.is_virtual ? "" : sensor.zone_type, static_cast<int>(sensor.filter.type));
+        }
+        for (int j=0; j < config->nb_cooling; j++) {
+            const cooling_config_t &cooling = config->cooling[j];
+            StringAppendF(&dump, "Cooling device %s: type %d, cooling %s\n", cooling.name,
+                          static_cast<int>(cooling.type), cooling.cooling_type);
+        }
+        emergency_stats_t stats = emergency_handler_.getStats();
+        StringAppendF(&dump, "Emergency: action %s from severity %d, %u events, %u actions, %u overruns\n",
+                      config->emergency.action == EmergencyAction::SHUTDOWN ? "shutdown" : "none",
+                      static_cast<int>(config->emergency.severity), stats.nb_event, stats.nb_action,
+                      stats.nb_overrun);
+        StringAppendF(&dump, "Emergency latency: notify %" PRId64 " us (max %" PRId64 " us), action %" PRId64
+                      " us (max %" PRId64 " us)\n", stats.last_notify_latency_ns / 1000,
+                      stats.max_notify_latency_ns / 1000, stats.last_action_latency_ns / 1000,
+                      stats.max_action_latency_ns / 1000);
+        hidl_vec<TemperatureStats> sensor_stats;
+        stats_collector_.getStats(false, TemperatureType::UNKNOWN, &sensor_stats);
+        for (const TemperatureStats &sensor : sensor_stats) {
+            for (const TemperatureWindowStats &window : sensor.windows) {
+                StringAppendF(&dump, "Stats %s %us: %u samples, min %.1f max %.1f mean %.2f", sensor.name.c_str(),
+                              window.windowMs / 1000, window.count, window.min, window.max, window.mean);
+                StringAppendF(&dump, " p50 %.1f p90 %.1f p99 %.1f\n", window.p50, window.p90, window.p99);
+            }
+        }
+        hidl_vec<CoolingResidency> residencies;
+        residency_collector_.getResidency(&residencies);
+        for (const CoolingResidency &residency : residencies) {
+            StringAppendF(&dump, "Residency %s: state %u/%u, %u transitions", residency.name.c_str(),
+                          residency.currentState, residency.maxState, residency.transitions);
+            for (size_t s=0; s < residency.residencyMs.size(); s++) {
+                StringAppendF(&dump, ", %zu: %" PRIu64 " ms (%u)", s, residency.residencyMs[s],
+                              residency.entries[s]);
+            }
+            dump += "\n";
+        }
+        headroom_estimator_.dump(&dump);
+        attribution_collector_.dump(&dump);
+        uclamp_advisor_.dump(&dump);
+        dumpJournal(kJournalDumpRecords, &dump);
+    }
+
+    if (!WriteStringToFd(dump, fd)) {
+        PLOG(ERROR) << "debug: failed to write dump";
+    }
+    return Void();
+}
+
 // Local functions to be used internally by a thermal daemon
 
-void Thermal::notifyThrottling(const Temperature& temperature) {
+void Thermal::monitorLoop() {
+    std::chrono::milliseconds retry = kDiscoveryRetryMin;
+    int64_t start = elapsedRealtime();
+
+    // Board configuration is loaded once, before discovery
+    std::shared_ptr<const thermal_config_t> config = loadThermalConfig();
+
+    std::unique_lock<std::mutex> _lock(monitor_mutex_);
+
+    // Clients are served stub data until discovery succeeds
+    while (true) {
+        // Discovery sees any thermal zone added before this point
+        rescan_pending_ = false;
+        bool reload = reload_pending_;
+        reload_pending_ = false;
+        _lock.unlock();
+        if (reload) {
+            config = loadThermalConfig();
+        }
+        bool res = initThermal(config);
+        _lock.lock();
+        if (res) {
+            break;
+        }
+        LOG(WARNING) << "Thermal discovery failed, retry in " << retry.count() << " ms";
+        if (!monitor_stop_ && !rescan_pending_ && !reload_pending_) {
+            _lock.unlock();
+            scheduler_.wait(std::chrono::nanoseconds(retry).count(), 0);
+            _lock.lock();
+        }
+        if (monitor_stop_) {
+            return;
+        }
+        retry = std::min(retry * 2, kDiscoveryRetryMax);
+    }
+    LOG(INFO) << "Thermal discovery completed in " << elapsedRealtime() - start << " ms ("
+              << elapsedRealtime() << " ms since boot)";
+
+    // Sampling is periodic while there is a demand, and stops completely otherwise
+    int64_t next_sample = 0;
+    while (true) {
+        // Polling period follows the configuration in use
+        int64_t period = getThermalConfig()->polling_period_ns;
+        int64_t now = elapsedRealtimeNano();
+        bool active = getDemand().total() > 0;
+        metrics_server_.setSamplingActive(active);
+        if (!active && next_sample != 0) {
+            // Time without sampling would be charged to the last sample
+            residency_collector_.restart();
+            headroom_estimator_.restart();
+        }
+        if (!active) {
+            // First sample is taken as soon as a demand appears
+            next_sample = 0;
+        }
+        if (!monitor_stop_ && !rescan_pending_ && !reload_pending_ && (!active || now < next_sample)) {
+            _lock.unlock();
+            scheduler_.wait(active ? next_sample - now : -1, period * kSamplingSlackPercent / 100);
+            _lock.lock();
+        }
+        if (monitor_stop_) {
+            break;
+        }
+        bool rescan = rescan_pending_;
+        bool reload = reload_pending_;
+        rescan_pending_ = false;
+        reload_pending_ = false;
+        _lock.unlock();
+
+        // New configuration is parsed and validated before anything is published
+        if (reload) {
+            reloadConfig();
+        }
+
+        // Readers keep using the previous topology until the new one is published
+        if (rescan && rescanThermal()) {
+            LOG(INFO) << "Thermal topology updated";
+        }
+
+        // Woken by a demand change, or before the deadline
+        if (getDemand().total() == 0 || elapsedRealtimeNano() < next_sample) {
+            _lock.lock();
+            continue;
+        }
+        next_sample = elapsedRealtimeNano() + getThermalConfig()->polling_period_ns;
+
+        // Thresholds table is only rebuilt when a kernel trip value changed
+        if (updateTemperatureThreshold()) {
+            LOG(INFO) << "Temperature thresholds updated";
+        }
+
+        // One pass per period, shared with clients through getSnapshot()
+        std::shared_ptr<const thermal_snapshot_t> snapshot = sampleThermal();
+        hidl_vec<Temperature_2_0> temperatures;
+        // Changes to emergency severities were notified by the emergency path
+        emergency_handler_.fillThrottlingChanges(*snapshot, &temperatures);
+        for (const Temperature_2_0 &temperature : temperatures) {
+            notifyThrottling(temperature);
+        }
+        notifyThresholds(*snapshot);
+        stats_collector_.update(*snapshot);
+        residency_collector_.update(*snapshot);
+        headroom_estimator_.update(*snapshot);
+        attribution_collector_.update(*snapshot);
+        uclamp_advisor_.update(*snapshot);
+        updateJournal(*snapshot);
+        _lock.lock();
+    }
+}
+
+/**
+ * Get back demands for periodic sampling
+ *
+ * @return demands, sampling being stopped when there is none
+ */
+sampling_demand_t Thermal::getDemand() {
+    std::shared_ptr<const thermal_config_t> config = getThermalConfig();
+    sampling_demand_t demand;
+
+    demand.callbacks = callback_registry_.size();
+    demand.subscriptions = threshold_registry_.size();
+    demand.telemetry = elapsedRealtimeNano() < telemetry_lease_ ? 1 : 0;
+    demand.headroom = elapsedRealtimeNano() < headroom_lease_ ? 1 : 0;
+    // Actuators only act on periodic samples
+    demand.actuators = (config->uclamp.nb_group > 0 ? 1 : 0) +
+                       (config->emergency.action != EmergencyAction::NONE ? 1 : 0);
+    return demand;
+}
+
+/**
+ * Renew a demand lease, periodic sampling being started if it was stopped
+ *
+ * @param lease Expiry of the lease, in elapsed realtime ns
+ */
+void Thermal::renewLease(std::atomic<int64_t> *lease) {
+    int64_t now = elapsedRealtimeNano();
+    int64_t expiry = now + getThermalConfig()->polling_period_ns * kSamplingLeasePeriods;
+
+    if (lease->exchange(expiry) <= now) {
+        scheduler_.wake();
+    }
+}
+
+void Thermal::requestRescan() {
+    {
+        std::lock_guard<std::mutex> _lock(monitor_mutex_);
+        rescan_pending_ = true;
+    }
+    scheduler_.wake();
+}
+
+void Thermal::requestReload() {
+    {
+        std::lock_guard<std::mutex> _lock(monitor_mutex_);
+        reload_pending_ = true;
+    }
+    scheduler_.wake();
+}
+
+/**
+ * Register a throttling callback, periodic sampling being started if it was stopped
+ *
+ * @param callback Callback to be notified
+ * @param filterType true if only events of type are notified
+ * @param type Temperature type, if filterType
+ *
+ * @return true on success or false if callback registered already or type invalid.
+ */
+bool Thermal::addThrottlingCallback(const sp<IThermalChangedCallback>& callback, bool filterType,
+                                    TemperatureType type) {
+    if (!callback_registry_.add(callback, filterType, type)) {
+        return false;
+    }
+    scheduler_.wake();
+    return true;
+}
+
+/**
+ * Unregister a throttling callback
+ *
+ * @param callback Callback used for registration
+ * @param filterType Pointer to filterType used for registration
+ * @param type Pointer to type used for registration
+ *
+ * @return true on success or false if callback was not registered.
+ */
+bool Thermal::removeThrottlingCallback(const sp<IThermalChangedCallback>& callback, bool* filterType,
+                                       TemperatureType* type) {
+    return callback_registry_.remove(callback, filterType, type);
+}
+
+void Thermal::reloadConfig() {
+    if constexpr (!BoardProfile::kRuntimeConfig) {
+        LOG(WARNING) << "Configuration fixed by board profile, reload ignored";
+        return;
+    }
+
+    std::string config_path = getThermalConfigPath();
+    std::shared_ptr<const thermal_config_t> config = parseThermalConfig(config_path);
+
+    // Current configuration is kept on any error
+    if (config == nullptr) {
+        LOG(ERROR) << "Failed to reload " << config_path << ", keep current configuration";
+        return;
+    }
+    if (getConfigChecksum(*config) == getConfigChecksum(*getThermalConfig())) {
+        LOG(INFO) << "Configuration " << config_path << " unchanged";
+        return;
+    }
+    if (reloadThermal(config)) {
+        LOG(INFO) << "Configuration reloaded from " << config_path;
+    }
+}
 
-    std::vector<CallbackSetting>::const_iterator iterator;
-    std::lock_guard<std::mutex> _lock(thermal_callback_mutex_);
-
-    if (callbacks_.size() > 0) {
-        for (iterator=callbacks_.begin(); iterator!=callbacks_.end(); iterator++) {
-            if ((*iterator).type == temperature.type || ! (*iterator).is_filter_type) {
-                Return<void> ret = (*iterator).callback->notifyThrottling(temperature);
-                if (!ret.isOk()) {
-                    if (ret.isDeadObject()) {
-                        LOG(WARNING) << "Dropped throttling event, ThermalChangedCallback died";
-                    } else {
-                        LOG(WARNING) << "Failed to send throttling event to ThermalChangedCallback";
-                    }
-                }
+void Thermal::notifyThresholds(const thermal_snapshot_t& snapshot) {
+    std::vector<threshold_notification_t> notifications;
+
+    // Callbacks are called with the registry unlocked
+    threshold_registry_.update(snapshot, &notifications);
+    for (const threshold_notification_t &notification : notifications) {
+        Return<void> ret = notification.callback->notifyThresholdCrossed(notification.event);
+        if (!ret.isOk()) {
+            if (ret.isDeadObject()) {
+                LOG(WARNING) << "ThermalThresholdCallback died, unregister its thresholds";
+                threshold_registry_.removeCallback(notification.callback);
+            } else {
+                LOG(WARNING) << "Failed to send threshold event to ThermalThresholdCallback";
             }
         }
     }
+}
 
+void Thermal::notifyThrottling(const Temperature& temperature) {
+    std::vector<sp<IThermalChangedCallback>> callbacks;
+
+    // Callbacks are called with the registry unlocked
+    callback_registry_.getCallbacks(temperature.type, &callbacks);
+    for (const sp<IThermalChangedCallback>& callback : callbacks) {
+        Return<void> ret = callback->notifyThrottling(temperature);
+        if (!ret.isOk()) {
+            if (ret.isDeadObject()) {
+                LOG(WARNING) << "Dropped throttling event, ThermalChangedCallback died";
+            } else {
+                LOG(WARNING) << "Failed to send throttling event to ThermalChangedCallback";
+            }
+        }
+    }
 }
 
 }  // namespace implementation
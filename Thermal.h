@@ -16,10 +16,28 @@
 #ifndef ANDROID_HARDWARE_THERMAL_V2_0_STM32MPU_THERMAL_H
 #define ANDROID_HARDWARE_THERMAL_V2_0_STM32MPU_THERMAL_H
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #include <android/hardware/thermal/2.0/IThermal.h>
+#include <vendor/stm32mpu/hardware/thermal/1.0/IThermalExt.h>
 #include <hidl/Status.h>
 #include <hidl/MQDescriptor.h>
 
+#include "thermal-attribution.h"
+#include "thermal-callback.h"
+#include "thermal-emergency.h"
+#include "thermal-headroom.h"
+#include "thermal-journal.h"
+#include "thermal-metrics.h"
+#include "thermal-residency.h"
+#include "thermal-sampling.h"
+#include "thermal-stats.h"
+#include "thermal-subscription.h"
+#include "thermal-uclamp.h"
+#include "thermal-uevent.h"
+
 namespace android {
 namespace hardware {
 namespace thermal {
@@ -28,6 +46,7 @@ namespace implementation {
 
 using ::android::sp;
 using ::android::hardware::hidl_array;
+using ::android::hardware::hidl_handle;
 using ::android::hardware::hidl_memory;
 using ::android::hardware::hidl_string;
 using ::android::hardware::hidl_vec;
@@ -44,18 +63,13 @@ using Temperature_2_0 = ::android::hardware::thermal::V2_0::Temperature;
 using ::android::hardware::thermal::V2_0::IThermalChangedCallback;
 using ::android::hardware::thermal::V2_0::TemperatureThreshold;
 using ::android::hardware::thermal::V2_0::TemperatureType;
+using ::vendor::stm32mpu::hardware::thermal::V1_0::IThermalExt;
+using ::vendor::stm32mpu::hardware::thermal::V1_0::ThermalState;
 
-struct CallbackSetting {
-    CallbackSetting(sp<IThermalChangedCallback> callback, bool is_filter_type, TemperatureType type)
-        : callback(callback), is_filter_type(is_filter_type), type(type) {}
-    sp<IThermalChangedCallback> callback;
-    bool is_filter_type;
-    TemperatureType type;
-};
-
-struct Thermal : public IThermal {
+struct Thermal : public IThermalExt {
     // Local functions
     Thermal();
+    ~Thermal();
     void notifyThrottling(const Temperature& temperature);
 
     // Methods from ::android::hardware::thermal::V1_0::IThermal follow.
@@ -77,11 +91,64 @@ struct Thermal : public IThermal {
     Return<void> getCurrentCoolingDevices(bool filterType, CoolingType_2_0 type,
                                           getCurrentCoolingDevices_cb _hidl_cb) override;
 
+    // Methods from ::vendor::stm32mpu::hardware::thermal::V1_0::IThermalExt follow.
+    Return<void> getTelemetryMemory(getTelemetryMemory_cb _hidl_cb) override;
+    Return<void> getThermalState(bool filterTemperatureType, TemperatureType temperatureType,
+                                 bool filterCoolingType, CoolingType_2_0 coolingType,
+                                 getThermalState_cb _hidl_cb) override;
+    Return<void> registerThresholdCallback(const sp<IThermalThresholdCallback>& callback,
+                                           const hidl_string& name, float threshold, float hysteresis,
+                                           registerThresholdCallback_cb _hidl_cb) override;
+    Return<void> unregisterThresholdCallback(const sp<IThermalThresholdCallback>& callback, uint32_t id,
+                                             unregisterThresholdCallback_cb _hidl_cb) override;
+    Return<void> getTemperatureStats(bool filterType, TemperatureType type,
+                                     getTemperatureStats_cb _hidl_cb) override;
+    Return<void> getCoolingResidency(getCoolingResidency_cb _hidl_cb) override;
+    Return<void> getTemperatureHeadroom(bool filterType, TemperatureType type, uint32_t forecastMs,
+                                        getTemperatureHeadroom_cb _hidl_cb) override;
+
+    // Methods from ::android::hidl::base::V1_0::IBase follow.
+    Return<void> debug(const hidl_handle& fd, const hidl_vec<hidl_string>& args) override;
+
+    // Parse board configuration again, and apply it if valid (asynchronous)
+    void requestReload();
+
+    // Throttling callbacks of any interface generation, sharing the registry
+    bool addThrottlingCallback(const sp<IThermalChangedCallback>& callback, bool filterType,
+                               TemperatureType type);
+    bool removeThrottlingCallback(const sp<IThermalChangedCallback>& callback, bool* filterType,
+                                  TemperatureType* type);
+
   private:
-    bool enabled_;
-    std::mutex thermal_callback_mutex_;
-    std::vector<CallbackSetting> callbacks_;
+    void monitorLoop();
+    void requestRescan();
+    void reloadConfig();
+    void notifyThresholds(const thermal_snapshot_t& snapshot);
+    sampling_demand_t getDemand();
+    void renewLease(std::atomic<int64_t> *lease);
+
+    CallbackRegistry callback_registry_;
+    EmergencyHandler emergency_handler_;
+
+    ThresholdRegistry threshold_registry_;
+    StatsCollector stats_collector_;
+    ResidencyCollector residency_collector_;
+    HeadroomEstimator headroom_estimator_;
+    AttributionCollector attribution_collector_;
+    UclampAdvisor uclamp_advisor_;
+    MetricsServer metrics_server_;
+
+    std::mutex monitor_mutex_;
+    SamplingScheduler scheduler_;
+    bool monitor_stop_;
+    bool rescan_pending_;
+    bool reload_pending_;
+    // Expiry of demand leases, in elapsed realtime ns
+    std::atomic<int64_t> telemetry_lease_;
+    std::atomic<int64_t> headroom_lease_;
+    std::thread monitor_thread_;
 
+    UeventListener uevent_listener_;
 };
 
 }  // namespace implementation
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android-base/logging.h>
+#include <cutils/native_handle.h>
+
+#include "ThermalAidl.h"
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace impl {
+namespace stm32mpu {
+
+using ::android::sp;
+using ::android::hardware::hidl_handle;
+using ::android::hardware::hidl_string;
+using ::android::hardware::hidl_vec;
+using ::android::hardware::Return;
+using ::android::hardware::Void;
+using ::android::hardware::thermal::V1_0::ThermalStatus;
+using CoolingDevice_2_0 = ::android::hardware::thermal::V2_0::CoolingDevice;
+using CoolingType_2_0 = ::android::hardware::thermal::V2_0::CoolingType;
+using Temperature_2_0 = ::android::hardware::thermal::V2_0::Temperature;
+using TemperatureThreshold_2_0 = ::android::hardware::thermal::V2_0::TemperatureThreshold;
+using TemperatureType_2_0 = ::android::hardware::thermal::V2_0::TemperatureType;
+using ::android::hardware::thermal::V2_0::implementation::kSeverityNum;
+
+// Enumerations of both interface generations share their values
+
+static TemperatureType_2_0 toHidl(TemperatureType type) {
+    return static_cast<TemperatureType_2_0>(type);
+}
+
+static CoolingType_2_0 toHidl(CoolingType type) {
+    return static_cast<CoolingType_2_0>(type);
+}
+
+static Temperature toAidl(const Temperature_2_0 &temperature) {
+    Temperature out;
+    out.type = static_cast<TemperatureType>(temperature.type);
+    out.name = temperature.name;
+    out.value = temperature.value;
+    out.throttlingStatus = static_cast<ThrottlingSeverity>(temperature.throttlingStatus);
+    return out;
+}
+
+static TemperatureThreshold toAidl(const TemperatureThreshold_2_0 &threshold) {
+    TemperatureThreshold out;
+    out.type = static_cast<TemperatureType>(threshold.type);
+    out.name = threshold.name;
+    out.hotThrottlingThresholds.assign(threshold.hotThrottlingThresholds.data(),
+                                       threshold.hotThrottlingThresholds.data() + kSeverityNum);
+    out.coldThrottlingThresholds.assign(threshold.coldThrottlingThresholds.data(),
+                                        threshold.coldThrottlingThresholds.data() + kSeverityNum);
+    return out;
+}
+
+static CoolingDevice toAidl(const CoolingDevice_2_0 &cooling_device) {
+    CoolingDevice out;
+    out.type = static_cast<CoolingType>(cooling_device.type);
+    out.name = cooling_device.name;
+    out.value = static_cast<int64_t>(cooling_device.value);
+    return out;
+}
+
+Return<void> ThrottlingCallbackAdapter::notifyThrottling(const Temperature_2_0 &temperature) {
+    ndk::ScopedAStatus status = callback_->notifyThrottling(toAidl(temperature));
+
+    if (!status.isOk()) {
+        LOG(WARNING) << "Failed to send throttling event to AIDL ThermalChangedCallback: "
+                     << status.getDescription();
+    }
+    return Void();
+}
+
+ThermalAidl::ThermalAidl(const sp<ThermalHidl> &thermal)
+    : thermal_(thermal),
+      death_recipient_(AIBinder_DeathRecipient_new(onBinderDied)) {}
+
+ThermalAidl::~ThermalAidl() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+    bool filter_type;
+    TemperatureType_2_0 type;
+
+    // No death notification must reach the frontend once destroyed
+    for (const auto &entry : callbacks_) {
+        AIBinder_unlinkToDeath(entry.first, death_recipient_.get(), this);
+        thermal_->removeThrottlingCallback(entry.second, &filter_type, &type);
+    }
+}
+
+ndk::ScopedAStatus ThermalAidl::getCoolingDevices(std::vector<CoolingDevice> *out_devices) {
+    return getCoolingDevices(false, CoolingType::FAN, out_devices);
+}
+
+ndk::ScopedAStatus ThermalAidl::getCoolingDevicesWithType(CoolingType type, std::vector<CoolingDevice> *out_devices) {
+    return getCoolingDevices(true, type, out_devices);
+}
+
+ndk::ScopedAStatus ThermalAidl::getTemperatures(std::vector<Temperature> *out_temperatures) {
+    return getTemperatures(false, TemperatureType::UNKNOWN, out_temperatures);
+}
+
+ndk::ScopedAStatus ThermalAidl::getTemperaturesWithType(TemperatureType type,
+                                                        std::vector<Temperature> *out_temperatures) {
+    return getTemperatures(true, type, out_temperatures);
+}
+
+ndk::ScopedAStatus ThermalAidl::getTemperatureThresholds(std::vector<TemperatureThreshold> *out_thresholds) {
+    return getTemperatureThresholds(false, TemperatureType::UNKNOWN, out_thresholds);
+}
+
+ndk::ScopedAStatus ThermalAidl::getTemperatureThresholdsWithType(TemperatureType type,
+                                                                 std::vector<TemperatureThreshold> *out_thresholds) {
+    return getTemperatureThresholds(true, type, out_thresholds);
+}
+
+ndk::ScopedAStatus ThermalAidl::registerThermalChangedCallback(
+    const std::shared_ptr<IThermalChangedCallback> &callback) {
+    return registerCallback(callback, false, TemperatureType::UNKNOWN);
+}
+
+ndk::ScopedAStatus ThermalAidl::registerThermalChangedCallbackWithType(
+    const std::shared_ptr<IThermalChangedCallback> &callback, TemperatureType type) {
+    return registerCallback(callback, true, type);
+}
+
+ndk::ScopedAStatus ThermalAidl::unregisterThermalChangedCallback(
+    const std::shared_ptr<IThermalChangedCallback> &callback) {
+    bool filter_type;
+    TemperatureType_2_0 type;
+
+    if (callback == nullptr) {
+        return ndk::ScopedAStatus::fromExceptionCodeWithMessage(EX_ILLEGAL_ARGUMENT, "Invalid nullptr callback");
+    }
+
+    std::lock_guard<std::mutex> _lock(mutex_);
+    auto entry = callbacks_.find(callback->asBinder().get());
+    if (entry == callbacks_.end()) {
+        return ndk::ScopedAStatus::fromExceptionCodeWithMessage(EX_ILLEGAL_ARGUMENT,
+                                                                "The callback was not registered before");
+    }
+    AIBinder_unlinkToDeath(entry->first, death_recipient_.get(), this);
+    thermal_->removeThrottlingCallback(entry->second, &filter_type, &type);
+    callbacks_.erase(entry);
+    LOG(INFO) << "An AIDL callback has been unregistered from ThermalHAL, isFilter: " << filter_type
+              << " Type: " << ::android::hardware::thermal::V2_0::toString(type);
+    return ndk::ScopedAStatus::ok();
+}
+
+/**
+ * Dump state, as lshal debug does for the HIDL service
+ */
+binder_status_t ThermalAidl::dump(int fd, const char **args, uint32_t num_args) {
+    native_handle_t *handle = native_handle_create(1, 0);
+    hidl_vec<hidl_string> hidl_args;
+
+    if (handle == nullptr) {
+        return STATUS_NO_MEMORY;
+    }
+    handle->data[0] = fd;
+    hidl_args.resize(num_args);
+    for (uint32_t i=0; i < num_args; i++) {
+        hidl_args[i] = args[i];
+    }
+    thermal_->debug(hidl_handle(handle), hidl_args);
+    native_handle_delete(handle);
+    return STATUS_OK;
+}
+
+// Lists are read from the shared engine through the HIDL frontend, an empty
+// list not being an error for AIDL clients
+
+ndk::ScopedAStatus ThermalAidl::getCoolingDevices(bool filter_type, CoolingType type,
+                                                  std::vector<CoolingDevice> *out) {
+    thermal_->getCurrentCoolingDevices(filter_type, toHidl(type),
+                                       [out](ThermalStatus, const hidl_vec<CoolingDevice_2_0> &devices) {
+        out->clear();
+        for (const CoolingDevice_2_0 &device : devices) {
+            out->push_back(toAidl(device));
+        }
+    });
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus ThermalAidl::getTemperatures(bool filter_type, TemperatureType type,
+                                                std::vector<Temperature> *out) {
+    thermal_->getCurrentTemperatures(filter_type, toHidl(type),
+                                     [out](ThermalStatus, const hidl_vec<Temperature_2_0> &temperatures) {
+        out->clear();
+        for (const Temperature_2_0 &temperature : temperatures) {
+            out->push_back(toAidl(temperature));
+        }
+    });
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus ThermalAidl::getTemperatureThresholds(bool filter_type, TemperatureType type,
+                                                         std::vector<TemperatureThreshold> *out) {
+    thermal_->getTemperatureThresholds(filter_type, toHidl(type),
+                                       [out](ThermalStatus, const hidl_vec<TemperatureThreshold_2_0> &thresholds) {
+        out->clear();
+        for (const TemperatureThreshold_2_0 &threshold : thresholds) {
+            out->push_back(toAidl(threshold));
+        }
+    });
+    return ndk::ScopedAStatus::ok();
+}
+
+/**
+ * Register an AIDL throttling callback in the shared registry, through an adapter
+ *
+ * @param callback Callback to be notified
+ * @param filter_type true if only events of type are notified
+ * @param type Temperature type, if filter_type
+ *
+ * @return status
+ */
+ndk::ScopedAStatus ThermalAidl::registerCallback(const std::shared_ptr<IThermalChangedCallback> &callback,
+                                                 bool filter_type, TemperatureType type) {
+    if (callback == nullptr) {
+        return ndk::ScopedAStatus::fromExceptionCodeWithMessage(EX_ILLEGAL_ARGUMENT, "Invalid nullptr callback");
+    }
+
+    std::lock_guard<std::mutex> _lock(mutex_);
+    AIBinder *binder = callback->asBinder().get();
+    if (callbacks_.count(binder) != 0) {
+        return ndk::ScopedAStatus::fromExceptionCodeWithMessage(EX_ILLEGAL_ARGUMENT,
+                                                                "Same callback interface registered already");
+    }
+    sp<ThrottlingCallbackAdapter> adapter = new ThrottlingCallbackAdapter(callback);
+    if (!thermal_->addThrottlingCallback(adapter, filter_type, toHidl(type))) {
+        return ndk::ScopedAStatus::fromExceptionCodeWithMessage(EX_ILLEGAL_ARGUMENT, "Invalid temperature type");
+    }
+
+    // Registration is kept even if death of client can't be tracked
+    if (AIBinder_linkToDeath(binder, death_recipient_.get(), this) != STATUS_OK) {
+        LOG(WARNING) << "Failed to link to death of AIDL ThermalChangedCallback";
+    }
+    callbacks_[binder] = adapter;
+    LOG(INFO) << "An AIDL callback has been registered to ThermalHAL, isFilter: " << filter_type
+              << " Type: " << toString(type);
+    return ndk::ScopedAStatus::ok();
+}
+
+void ThermalAidl::onBinderDied(void *cookie) {
+    LOG(WARNING) << "AIDL ThermalChangedCallback died, unregister it";
+    static_cast<ThermalAidl *>(cookie)->removeDeadCallbacks();
+}
+
+/**
+ * Unregister callbacks of dead clients, death notifications not telling which binder died
+ */
+void ThermalAidl::removeDeadCallbacks() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+    bool filter_type;
+    TemperatureType_2_0 type;
+
+    for (auto entry = callbacks_.begin(); entry != callbacks_.end();) {
+        if (AIBinder_isAlive(entry->first)) {
+            ++entry;
+            continue;
+        }
+        thermal_->removeThrottlingCallback(entry->second, &filter_type, &type);
+        entry = callbacks_.erase(entry);
+    }
+}
+
+}  // namespace stm32mpu
+}  // namespace impl
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ANDROID_HARDWARE_THERMAL_AIDL_STM32MPU_THERMAL_H
+#define ANDROID_HARDWARE_THERMAL_AIDL_STM32MPU_THERMAL_H
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <aidl/android/hardware/thermal/BnThermal.h>
+
+#include "Thermal.h"
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace impl {
+namespace stm32mpu {
+
+using ThermalHidl = ::android::hardware::thermal::V2_0::implementation::Thermal;
+
+// Throttling callback of an AIDL client, registered in the callback registry
+// shared with HIDL clients: events reach both from the same monitor pass.
+class ThrottlingCallbackAdapter : public ::android::hardware::thermal::V2_0::IThermalChangedCallback {
+  public:
+    explicit ThrottlingCallbackAdapter(
+        const std::shared_ptr<::aidl::android::hardware::thermal::IThermalChangedCallback> &callback)
+        : callback_(callback) {}
+
+    ::android::hardware::Return<void> notifyThrottling(
+        const ::android::hardware::thermal::V2_0::Temperature &temperature) override;
+
+  private:
+    std::shared_ptr<::aidl::android::hardware::thermal::IThermalChangedCallback> callback_;
+};
+
+// AIDL IThermal frontend, a thin adapter over the HIDL service: both share
+// the sampling engine, the monitor thread and the callback registry.
+class ThermalAidl : public BnThermal {
+  public:
+    explicit ThermalAidl(const ::android::sp<ThermalHidl> &thermal);
+    ~ThermalAidl();
+
+    ndk::ScopedAStatus getCoolingDevices(std::vector<CoolingDevice> *out_devices) override;
+    ndk::ScopedAStatus getCoolingDevicesWithType(CoolingType type, std::vector<CoolingDevice> *out_devices) override;
+    ndk::ScopedAStatus getTemperatures(std::vector<Temperature> *out_temperatures) override;
+    ndk::ScopedAStatus getTemperaturesWithType(TemperatureType type,
+                                               std::vector<Temperature> *out_temperatures) override;
+    ndk::ScopedAStatus getTemperatureThresholds(std::vector<TemperatureThreshold> *out_thresholds) override;
+    ndk::ScopedAStatus getTemperatureThresholdsWithType(TemperatureType type,
+                                                        std::vector<TemperatureThreshold> *out_thresholds) override;
+    ndk::ScopedAStatus registerThermalChangedCallback(
+        const std::shared_ptr<IThermalChangedCallback> &callback) override;
+    ndk::ScopedAStatus registerThermalChangedCallbackWithType(
+        const std::shared_ptr<IThermalChangedCallback> &callback, TemperatureType type) override;
+    ndk::ScopedAStatus unregisterThermalChangedCallback(
+        const std::shared_ptr<IThermalChangedCallback> &callback) override;
+
+    binder_status_t dump(int fd, const char **args, uint32_t num_args) override;
+
+  private:
+    ndk::ScopedAStatus getCoolingDevices(bool filter_type, CoolingType type, std::vector<CoolingDevice> *out);
+    ndk::ScopedAStatus getTemperatures(bool filter_type, TemperatureType type, std::vector<Temperature> *out);
+    ndk::ScopedAStatus getTemperatureThresholds(bool filter_type, TemperatureType type,
+                                                std::vector<TemperatureThreshold> *out);
+    ndk::ScopedAStatus registerCallback(const std::shared_ptr<IThermalChangedCallback> &callback,
+                                        bool filter_type, TemperatureType type);
+    static void onBinderDied(void *cookie);
+    void removeDeadCallbacks();
+
+    ::android::sp<ThermalHidl> thermal_;
+
+    std::mutex mutex_;
+    ndk::ScopedAIBinder_DeathRecipient death_recipient_;
+    // Binder of the AIDL callback to its adapter in the shared registry
+    std::map<AIBinder *, ::android::sp<ThrottlingCallbackAdapter>> callbacks_;
+};
+
+}  // namespace stm32mpu
+}  // namespace impl
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
+
+#endif  // ANDROID_HARDWARE_THERMAL_AIDL_STM32MPU_THERMAL_H
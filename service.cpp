@@ -15,9 +15,17 @@
  */
 #define LOG_TAG "android.hardware.thermal@2.0-service.stm32mpu"
 
+#include <signal.h>
+
+#include <thread>
+
 #include <android-base/logging.h>
+#include <android/binder_manager.h>
+#include <android/binder_process.h>
 #include <hidl/HidlTransportSupport.h>
+#include <utils/SystemClock.h>
 #include "Thermal.h"
+#include "ThermalAidl.h"
 
 using ::android::OK;
 using ::android::status_t;
@@ -30,22 +38,50 @@ using ::android::hardware::joinRpcThreadpool;
 using ::android::hardware::thermal::V2_0::IThermal;
 using ::android::hardware::thermal::V2_0::implementation::Thermal;
 
+// Generated AIDL files:
+using ::aidl::android::hardware::thermal::impl::stm32mpu::ThermalAidl;
+
 static int shutdown() {
     LOG(ERROR) << "Thermal Service is shutting down.";
     return 1;
 }
 
+/**
+ * Reload board configuration on SIGHUP, SIGHUP being blocked in all threads
+ *
+ * @param thermal Service instance
+ */
+static void reloadOnSighup(const android::sp<Thermal> &thermal) {
+    sigset_t mask;
+    int signal;
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGHUP);
+    while (sigwait(&mask, &signal) == 0) {
+        LOG(INFO) << "SIGHUP received, reloading configuration";
+        thermal->requestReload();
+    }
+}
+
 int main(int /* argc */, char** /* argv */) {
     status_t status;
-    android::sp<IThermal> service = nullptr;
+    android::sp<Thermal> service = nullptr;
+    int64_t start = android::elapsedRealtime();
+    sigset_t mask;
 
     LOG(INFO) << "Thermal HAL Service Mock 2.0 starting...";
 
+    // Blocked before any thread is created, so that only reloadOnSighup() receives it
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
     service = new Thermal();
     if (service == nullptr) {
         LOG(ERROR) << "Error creating an instance of ThermalHAL.  Exiting...";
         return shutdown();
     }
+    std::thread(reloadOnSighup, service).detach();
 
     configureRpcThreadpool(1, true /* callerWillJoin */);
 
@@ -55,7 +91,19 @@ int main(int /* argc */, char** /* argv */) {
         return shutdown();
     }
 
-    LOG(INFO) << "Thermal Service started successfully.";
+    // AIDL frontend served by its own binder thread, on the same engine and monitor thread
+    std::shared_ptr<ThermalAidl> aidl_service = ndk::SharedRefBase::make<ThermalAidl>(service);
+    const std::string instance = std::string(ThermalAidl::descriptor) + "/default";
+    ABinderProcess_setThreadPoolMaxThreadCount(1);
+    ABinderProcess_startThreadPool();
+    if (AServiceManager_addService(aidl_service->asBinder().get(), instance.c_str()) != STATUS_OK) {
+        LOG(ERROR) << "Could not register service for AIDL ThermalHAL";
+        return shutdown();
+    }
+
+    // Sysfs discovery is still running at this point: it is not part of service startup
+    LOG(INFO) << "Thermal Service started successfully in " << android::elapsedRealtime() - start
+              << " ms (" << android::elapsedRealtime() << " ms since boot).";
     joinRpcThreadpool();
     // We should not get past the joinRpcThreadpool().
     return shutdown();
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+#include <android-base/unique_fd.h>
+#include <utils/SystemClock.h>
+
+#include "thermal-attribution.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::StringAppendF;
+
+static_assert((kAttributionTableSize & (kAttributionTableSize - 1)) == 0, "table size must be a power of 2");
+
+AttributionCollector::AttributionCollector()
+    : severity_(), table_(), current_(0), last_scan_(0), previous_scan_(0), nb_scan_(0), nb_top_(0), top_(), nb_record_(0),
+      history_() {}
+
+/**
+ * Find slot of a process in a CPU time table (linear probing)
+ *
+ * @param table Table of kAttributionTableSize slots
+ * @param pid Process identifier
+ *
+ * @return slot of pid, or free slot it must be added to, or -1 if table is full
+ */
+template <typename T>
+static int findSlot(T *table, int pid) {
+    uint32_t hash = static_cast<uint32_t>(pid) * 2654435761U;
+
+    for (int i=0; i < kAttributionTableSize; i++) {
+        int slot = (hash + i) & (kAttributionTableSize - 1);
+        if (table[slot].pid == pid || table[slot].pid == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Read name and CPU time of a process
+ *
+ * @param pid Process identifier
+ * @param comm Pointer to name (16 bytes)
+ * @param ticks Pointer to utime + stime, in clock ticks
+ *
+ * @return true on success or false on error (process exited).
+ */
+static bool readProcessStat(int pid, char *comm, uint64_t *ticks) {
+    char file_name[PATH_MAX];
+    char buf[512];
+    uint64_t utime, stime;
+
+    sprintf(file_name, kProcStatFileFormat, pid);
+    android::base::unique_fd fd(TEMP_FAILURE_RETRY(open(file_name, O_RDONLY | O_CLOEXEC)));
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t len = TEMP_FAILURE_RETRY(read(fd, buf, sizeof(buf) - 1));
+    if (len <= 0) {
+        return false;
+    }
+    buf[len] = '\0';
+
+    // "pid (comm) state ...", comm may hold spaces and parenthesis
+    char *begin = strchr(buf, '(');
+    char *end = strrchr(buf, ')');
+    if (begin == nullptr || end == nullptr || end < begin) {
+        return false;
+    }
+    size_t comm_len = std::min<size_t>(end - begin - 1, 15);
+    memcpy(comm, begin + 1, comm_len);
+    comm[comm_len] = '\0';
+
+    // utime and stime are fields 14 and 15, state being field 3
+    if (2 != sscanf(end + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %" SCNu64 " %" SCNu64, &utime,
+                    &stime)) {
+        return false;
+    }
+    *ticks = utime + stime;
+    return true;
+}
+
+/**
+ * Scan all processes, and compute top consumers since previous scan
+ *
+ * @param now Timestamp of the scan
+ *
+ * @return true on success or false on error.
+ */
+bool AttributionCollector::scan(int64_t now) {
+    cpu_time_t *previous = table_[current_];
+    cpu_time_t *next = table_[1 - current_];
+    char comm[16];
+    uint64_t ticks;
+
+    std::unique_ptr<DIR, int (*)(DIR *)> dir(opendir(kProcDir), closedir);
+    if (dir == nullptr) {
+        PLOG(ERROR) << "AttributionCollector: failed to open " << kProcDir;
+        return false;
+    }
+
+    memset(next, 0, sizeof(table_[0]));
+    nb_top_ = 0;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir.get())) != nullptr) {
+        if (!isdigit(entry->d_name[0])) {
+            continue;
+        }
+        int pid = atoi(entry->d_name);
+        if (pid <= 0 || !readProcessStat(pid, comm, &ticks)) {
+            continue;
+        }
+        int slot = findSlot(next, pid);
+        if (slot < 0) {
+            continue;
+        }
+        next[slot].pid = pid;
+        next[slot].ticks = ticks;
+
+        if (nb_scan_ == 0) {
+            continue;
+        }
+        // Processes started since previous scan are accounted from 0
+        int old = findSlot(previous, pid);
+        uint64_t delta = ticks;
+        if (old >= 0 && previous[old].pid == pid) {
+            delta = (ticks >= previous[old].ticks) ? ticks - previous[old].ticks : 0;
+        }
+        if (delta == 0) {
+            continue;
+        }
+
+        // Top consumers are kept sorted, highest first
+        int i = nb_top_;
+        if (i == kAttributionTopNum) {
+            if (delta <= top_[i - 1].ticks) {
+                continue;
+            }
+            i--;
+        } else {
+            nb_top_++;
+        }
+        while (i > 0 && top_[i - 1].ticks < delta) {
+            top_[i] = top_[i - 1];
+            i--;
+        }
+        top_[i].pid = pid;
+        strcpy(top_[i].comm, comm);
+        top_[i].ticks = delta;
+    }
+
+    current_ = 1 - current_;
+    previous_scan_ = last_scan_;
+    last_scan_ = now;
+    nb_scan_++;
+    return true;
+}
+
+/**
+ * Record top consumers of last scans against a severity rise
+ *
+ * @param snapshot Sample the rise was seen on
+ * @param sample Temperature of the sensor
+ */
+void AttributionCollector::record(const thermal_snapshot_t &snapshot, const temperature_sample_t &sample) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+    attribution_record_t &record = history_[nb_record_ % kAttributionHistorySize];
+
+    record.timestamp = snapshot.timestamp;
+    strcpy(record.sensor, snapshot.config->sensor[sample.name].name);
+    record.severity = sample.severity;
+    record.value = sample.value;
+    record.interval_ns = last_scan_ - previous_scan_;
+    record.nb_consumer = nb_top_;
+    std::copy(top_, top_ + nb_top_, record.consumer);
+    nb_record_++;
+}
+
+/**
+ * Check a periodic sample for severity rises, and scan processes if needed
+ *
+ * @param snapshot New sample
+ */
+void AttributionCollector::update(const thermal_snapshot_t &snapshot) {
+    int64_t since_scan = snapshot.timestamp - last_scan_;
+    bool scanned = false;
+
+    // Severities are tracked per configured sensor, and reset by a new configuration
+    if (config_ != snapshot.config) {
+        config_ = snapshot.config;
+        std::fill(severity_, severity_ + kMaxSensors, ThrottlingSeverity::NONE);
+    }
+
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        ThrottlingSeverity previous = severity_[sample.name];
+        severity_[sample.name] = sample.severity;
+        if (sample.severity <= previous) {
+            continue;
+        }
+
+        // Consumers of a rise are computed once per minimum interval at most
+        if (!scanned && (nb_scan_ < 2 || since_scan >= kAttributionMinIntervalNs)) {
+            scanned = scan(snapshot.timestamp);
+        }
+        if (nb_scan_ >= 2) {
+            record(snapshot, sample);
+        }
+    }
+
+    // Baseline for next rise
+    if (!scanned && (nb_scan_ == 0 || since_scan >= kAttributionMaxIntervalNs)) {
+        scan(snapshot.timestamp);
+    }
+}
+
+/**
+ * Dump attribution history
+ *
+ * @param out Pointer to dump, oldest record first
+ */
+void AttributionCollector::dump(std::string *out) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+    int first = std::max(0, nb_record_ - kAttributionHistorySize);
+    long tick_ms = 1000 / sysconf(_SC_CLK_TCK);
+
+    for (int r=first; r < nb_record_; r++) {
+        const attribution_record_t &record = history_[r % kAttributionHistorySize];
+        StringAppendF(out, "Attribution at %" PRId64 " ms: %s %.1f C severity %d, over %" PRId64 " ms:",
+                      record.timestamp / 1000000, record.sensor, record.value,
+                      static_cast<int>(record.severity), record.interval_ns / 1000000);
+        for (int i=0; i < record.nb_consumer; i++) {
+            const attribution_consumer_t &consumer = record.consumer[i];
+            StringAppendF(out, " %d (%s) %" PRIu64 " ms", consumer.pid, consumer.comm, consumer.ticks * tick_ms);
+        }
+        *out += "\n";
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_ATTRIBUTION_H__
+#define __THERMAL_ATTRIBUTION_H__
+
+#include <mutex>
+#include <string>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Path to get back CPU time of processes
+constexpr const char *kProcDir = "/proc";
+constexpr const char *kProcStatFileFormat = "/proc/%d/stat";
+
+// Capacity of CPU time tables (power of 2), processes beyond it being ignored
+constexpr int kAttributionTableSize = 4096;
+
+// Number of top consumers recorded, and number of records kept
+constexpr int kAttributionTopNum = 5;
+constexpr int kAttributionHistorySize = 16;
+
+// Process scans are done at most once per kAttributionMinIntervalNs, and at
+// least once per kAttributionMaxIntervalNs, so that a transition always finds
+// a recent baseline
+constexpr int64_t kAttributionMinIntervalNs = 1000000000LL;
+constexpr int64_t kAttributionMaxIntervalNs = 10000000000LL;
+
+struct attribution_consumer_t {
+    int                 pid;
+    char                comm[16];
+    uint64_t            ticks;          // CPU time between the two scans
+};
+
+// Top CPU consumers when a sensor severity rose
+struct attribution_record_t {
+    int64_t                 timestamp;      // elapsed realtime in ns
+    char                    sensor[32];
+    ThrottlingSeverity      severity;
+    float                   value;
+    int64_t                 interval_ns;    // between the two scans consumers are computed from
+    int                     nb_consumer;
+    attribution_consumer_t  consumer[kAttributionTopNum];
+};
+
+// Attributes severity rises to the processes which consumed most CPU time
+// just before. Processes are scanned in a single pass, CPU time of previous
+// scan being found in an open-addressing table: two fixed tables are used in
+// turn, the previous one being the lookup table of the next scan.
+class AttributionCollector {
+  public:
+    AttributionCollector();
+
+    void update(const thermal_snapshot_t &snapshot);
+    void dump(std::string *out);
+
+  private:
+    struct cpu_time_t {
+        int                 pid;            // 0 if free
+        uint64_t            ticks;          // utime + stime
+    };
+
+    bool scan(int64_t now);
+    void record(const thermal_snapshot_t &snapshot, const temperature_sample_t &sample);
+
+    // Severity of configured sensors, rises being attributed
+    std::shared_ptr<const thermal_config_t> config_;
+    ThrottlingSeverity severity_[kMaxSensors];
+
+    // CPU time tables of last scan (current_) and of the scan before
+    cpu_time_t table_[2][kAttributionTableSize];
+    int current_;
+    int64_t last_scan_;
+    int64_t previous_scan_;
+    int nb_scan_;
+
+    // Top consumers between the two last scans
+    int nb_top_;
+    attribution_consumer_t top_[kAttributionTopNum];
+
+    std::mutex mutex_;
+    int nb_record_;
+    attribution_record_t history_[kAttributionHistorySize];  // ring, oldest first once full
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_ATTRIBUTION_H__
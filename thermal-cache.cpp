@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <android-base/logging.h>
+#include <android-base/unique_fd.h>
+
+#include "thermal-cache.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::unique_fd;
+
+// Topology is stored as is: any layout change must bump the version
+static_assert(std::is_trivially_copyable<thermal_topology_t>::value,
+              "thermal_topology_t must be trivially copyable to be cached");
+
+constexpr uint32_t kDiscoveryCacheMagic = 0x48545453;  // "STTH"
+constexpr uint32_t kDiscoveryCacheVersion = 4;
+
+struct discovery_cache_t {
+    uint32_t            magic;
+    uint32_t            version;
+    uint32_t            size;       // size of topology
+    uint32_t            checksum;   // FNV-1a of topology
+    uint32_t            config_checksum;    // board configuration the topology was built with
+    thermal_topology_t  topology;
+};
+
+/**
+ * Compute checksum of a buffer (32-bit FNV-1a)
+ *
+ * @param data Pointer to data
+ * @param size Size of data
+ *
+ * @return checksum
+ */
+uint32_t getChecksum(const void *data, size_t size) {
+    const uint8_t *byte = static_cast<const uint8_t *>(data);
+    uint32_t hash = 2166136261u;
+
+    for (size_t i=0; i < size; i++) {
+        hash = (hash ^ byte[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Load topology found on a previous boot
+ *
+ * @param topology Pointer to topology loaded
+ * @param config_checksum Checksum of current board configuration
+ *
+ * @return true on success or false if no valid cache is available.
+ */
+bool loadDiscoveryCache(thermal_topology_t *topology, uint32_t config_checksum) {
+    struct stat st;
+
+    unique_fd fd(TEMP_FAILURE_RETRY(open(kDiscoveryCacheFile, O_RDONLY | O_CLOEXEC)));
+    if (fd < 0) {
+        if (errno != ENOENT) {
+            PLOG(WARNING) << "loadDiscoveryCache: failed to open file (" << kDiscoveryCacheFile << ")";
+        }
+        return false;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size != sizeof(discovery_cache_t)) {
+        LOG(WARNING) << "loadDiscoveryCache: unexpected file size";
+        return false;
+    }
+
+    void *map = mmap(nullptr, sizeof(discovery_cache_t), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        PLOG(WARNING) << "loadDiscoveryCache: failed to map file (" << kDiscoveryCacheFile << ")";
+        return false;
+    }
+
+    const discovery_cache_t *cache = static_cast<const discovery_cache_t *>(map);
+    bool valid = cache->magic == kDiscoveryCacheMagic &&
+                 cache->version == kDiscoveryCacheVersion &&
+                 cache->size == sizeof(thermal_topology_t) &&
+                 cache->checksum == getChecksum(&cache->topology, sizeof(thermal_topology_t));
+    if (!valid) {
+        LOG(WARNING) << "loadDiscoveryCache: invalid file (" << kDiscoveryCacheFile << ")";
+    } else if (cache->config_checksum != config_checksum) {
+        // Sensors are associated with thermal zones based on configuration
+        LOG(INFO) << "loadDiscoveryCache: board configuration changed";
+        valid = false;
+    } else {
+        memcpy(topology, &cache->topology, sizeof(thermal_topology_t));
+    }
+    munmap(map, sizeof(discovery_cache_t));
+
+    return valid;
+}
+
+/**
+ * Save topology found by a full discovery, for next boots
+ *
+ * @param topology Topology to be saved
+ * @param config_checksum Checksum of board configuration the topology was built with
+ *
+ * @return true on success or false on error.
+ */
+bool saveDiscoveryCache(const thermal_topology_t &topology, uint32_t config_checksum) {
+    std::string tmp_name = std::string(kDiscoveryCacheFile) + ".tmp";
+    discovery_cache_t cache;
+
+    memset(&cache, 0, sizeof(cache));
+    cache.magic = kDiscoveryCacheMagic;
+    cache.version = kDiscoveryCacheVersion;
+    cache.size = sizeof(thermal_topology_t);
+    memcpy(&cache.topology, &topology, sizeof(thermal_topology_t));
+    cache.checksum = getChecksum(&cache.topology, sizeof(thermal_topology_t));
+    cache.config_checksum = config_checksum;
+
+    // Written to a temporary file first, so that a valid cache is never partially overwritten
+    unique_fd fd(TEMP_FAILURE_RETRY(
+        open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640)));
+    if (fd < 0) {
+        PLOG(WARNING) << "saveDiscoveryCache: failed to open file (" << tmp_name << ")";
+        return false;
+    }
+    if (TEMP_FAILURE_RETRY(write(fd, &cache, sizeof(cache))) != sizeof(cache) || fsync(fd) < 0) {
+        PLOG(WARNING) << "saveDiscoveryCache: failed to write file (" << tmp_name << ")";
+        unlink(tmp_name.c_str());
+        return false;
+    }
+    fd.reset();
+
+    if (rename(tmp_name.c_str(), kDiscoveryCacheFile) < 0) {
+        PLOG(WARNING) << "saveDiscoveryCache: failed to rename file (" << tmp_name << ")";
+        unlink(tmp_name.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Remove topology saved on a previous boot, once found not to match the platform
+ */
+void removeDiscoveryCache() {
+    if (unlink(kDiscoveryCacheFile) < 0 && errno != ENOENT) {
+        PLOG(WARNING) << "removeDiscoveryCache: failed to remove file (" << kDiscoveryCacheFile << ")";
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_CACHE_H__
+#define __THERMAL_CACHE_H__
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Topology found by the last full discovery, reused on next boots
+constexpr const char *kDiscoveryCacheFile = "/data/vendor/thermal/discovery.bin";
+
+uint32_t getChecksum(const void *data, size_t size);
+bool loadDiscoveryCache(thermal_topology_t *topology, uint32_t config_checksum);
+bool saveDiscoveryCache(const thermal_topology_t &topology, uint32_t config_checksum);
+void removeDiscoveryCache();
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_CACHE_H__
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include <android-base/logging.h>
+#include <hidl/HidlBinderSupport.h>
+
+#include "thermal-callback.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::hardware::toBinder;
+
+void CallbackRegistry::DeathRecipient::serviceDied(uint64_t cookie, const wp<IBase> & /* who */) {
+    LOG(WARNING) << "ThermalChangedCallback died, unregister it";
+    registry_->removeCookie(cookie);
+}
+
+CallbackRegistry::CallbackRegistry() : death_recipient_(new DeathRecipient(this)) {}
+
+CallbackRegistry::~CallbackRegistry() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    // No death notification must reach the registry once destroyed
+    for (const auto &entry : callbacks_) {
+        entry.second.callback->unlinkToDeath(death_recipient_);
+    }
+}
+
+/**
+ * Get back identity of a callback, same for all proxies of a remote callback
+ *
+ * @param callback Callback
+ *
+ * @return binder address, used as key and death cookie
+ */
+uint64_t CallbackRegistry::getCookie(const sp<IThermalChangedCallback> &callback) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(toBinder<IBase>(callback).get()));
+}
+
+/**
+ * Register a throttling callback
+ *
+ * @param callback Callback to be notified
+ * @param filter_type true if only events of type are notified
+ * @param type Temperature type, if filter_type
+ *
+ * @return true on success or false if callback registered already or type invalid.
+ */
+bool CallbackRegistry::add(const sp<IThermalChangedCallback> &callback, bool filter_type,
+                           TemperatureType type) {
+    int bucket = kAllTypesBucket;
+    uint64_t cookie = getCookie(callback);
+
+    if (filter_type) {
+        bucket = static_cast<int>(type) + 1;
+        if (bucket < 0 || bucket >= kTemperatureTypeNum) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    if (callbacks_.count(cookie) != 0) {
+        return false;
+    }
+
+    // Registration is kept even if death of client can't be tracked
+    Return<bool> linked = callback->linkToDeath(death_recipient_, cookie);
+    if (!linked.isOk() || !linked) {
+        LOG(WARNING) << "Failed to link to death of ThermalChangedCallback";
+    }
+
+    callbacks_[cookie] = {callback, filter_type, type, bucket};
+    bucket_[bucket].push_back(callback);
+    return true;
+}
+
+/**
+ * Remove a callback from its bucket, mutex_ being held
+ *
+ * @param setting Registration to be removed
+ */
+void CallbackRegistry::erase(const callback_setting_t &setting) {
+    std::vector<sp<IThermalChangedCallback>> &bucket = bucket_[setting.bucket];
+
+    // Registration order is kept in bucket
+    bucket.erase(std::find(bucket.begin(), bucket.end(), setting.callback));
+}
+
+/**
+ * Unregister a throttling callback
+ *
+ * @param callback Callback used for registration
+ * @param filter_type Pointer to filter_type used for registration
+ * @param type Pointer to type used for registration
+ *
+ * @return true on success or false if callback was not registered.
+ */
+bool CallbackRegistry::remove(const sp<IThermalChangedCallback> &callback, bool *filter_type,
+                              TemperatureType *type) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    auto setting = callbacks_.find(getCookie(callback));
+    if (setting == callbacks_.end()) {
+        return false;
+    }
+    *filter_type = setting->second.is_filter_type;
+    *type = setting->second.type;
+    setting->second.callback->unlinkToDeath(death_recipient_);
+    erase(setting->second);
+    callbacks_.erase(setting);
+    return true;
+}
+
+/**
+ * Unregister the callback of a dead client
+ *
+ * @param cookie Identity of the callback
+ */
+void CallbackRegistry::removeCookie(uint64_t cookie) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    auto setting = callbacks_.find(cookie);
+    if (setting == callbacks_.end()) {
+        return;
+    }
+    erase(setting->second);
+    callbacks_.erase(setting);
+}
+
+/**
+ * Get back number of registered callbacks
+ *
+ * @return number of callbacks
+ */
+size_t CallbackRegistry::size() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    return callbacks_.size();
+}
+
+/**
+ * Get back callbacks interested in an event, to be called with the registry unlocked
+ *
+ * @param type Temperature type of the event
+ * @param callbacks Pointer to callbacks
+ */
+void CallbackRegistry::getCallbacks(TemperatureType type, std::vector<sp<IThermalChangedCallback>> *callbacks) {
+    int bucket = static_cast<int>(type) + 1;
+
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    callbacks->clear();
+    if (bucket >= 0 && bucket < kTemperatureTypeNum) {
+        callbacks->insert(callbacks->end(), bucket_[bucket].begin(), bucket_[bucket].end());
+    }
+    callbacks->insert(callbacks->end(), bucket_[kAllTypesBucket].begin(), bucket_[kAllTypesBucket].end());
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_CALLBACK_H__
+#define __THERMAL_CALLBACK_H__
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <android/hardware/thermal/2.0/IThermal.h>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::wp;
+using ::android::hardware::hidl_death_recipient;
+using ::android::hardware::thermal::V2_0::IThermalChangedCallback;
+using ::android::hidl::base::V1_0::IBase;
+
+// Throttling callbacks registered by clients. Callbacks are stored in the
+// bucket of the temperature type they filter, or in the bucket of all types,
+// so that an event only walks the callbacks interested in it. Registration
+// identity is the binder of the callback, and callbacks are unregistered
+// as soon as their client dies.
+class CallbackRegistry {
+  public:
+    CallbackRegistry();
+    ~CallbackRegistry();
+
+    bool add(const sp<IThermalChangedCallback> &callback, bool filter_type, TemperatureType type);
+    bool remove(const sp<IThermalChangedCallback> &callback, bool *filter_type, TemperatureType *type);
+
+    void getCallbacks(TemperatureType type, std::vector<sp<IThermalChangedCallback>> *callbacks);
+    size_t size();
+
+  private:
+    class DeathRecipient : public hidl_death_recipient {
+      public:
+        explicit DeathRecipient(CallbackRegistry *registry) : registry_(registry) {}
+        void serviceDied(uint64_t cookie, const wp<IBase> &who) override;
+
+      private:
+        CallbackRegistry *registry_;
+    };
+
+    struct callback_setting_t {
+        sp<IThermalChangedCallback> callback;
+        bool                        is_filter_type;
+        TemperatureType             type;
+        int                         bucket;
+    };
+
+    // Bucket of callbacks not filtering temperature type, type ones being indexed by type + 1
+    static constexpr int kAllTypesBucket = kTemperatureTypeNum;
+
+    static uint64_t getCookie(const sp<IThermalChangedCallback> &callback);
+    void erase(const callback_setting_t &setting);
+    void removeCookie(uint64_t cookie);
+
+    std::mutex mutex_;
+    sp<DeathRecipient> death_recipient_;
+    // Binder of the callback (also used as death cookie) to registration
+    std::unordered_map<uint64_t, callback_setting_t> callbacks_;
+    std::vector<sp<IThermalChangedCallback>> bucket_[kTemperatureTypeNum + 1];
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_CALLBACK_H__
@@ -0,0 +1,579 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <android-base/logging.h>
+#include <android-base/properties.h>
+#include <json/reader.h>
+#include <json/value.h>
+
+#include "thermal-cache.h"
+#include "thermal-config.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+/* ------------------------------------------------------------ */
+/* Default board configuration, built from board profile tables */
+/* ------------------------------------------------------------ */
+
+// Kernel trip type associated with severities
+constexpr const char *kSeverityThreshold[kSeverityNum] =
+    {"none", "active0", "active1", "passive", "critical", "emergency", "shutdown"};
+
+// Polling period and kernel temperature multiplier
+constexpr int64_t kPollingPeriodNs = 1000000000LL;
+constexpr float kTemperatureMult = 0.0001;
+
+// Default cgroup root and hysteresis of the uclamp advisor
+constexpr const char *kUclampRoot = "/dev/cpuctl";
+constexpr float kUclampHysteresis = 2.0;
+
+// Accepted polling periods
+constexpr int64_t kMinPollingPeriodMs = 100;
+constexpr int64_t kMaxPollingPeriodMs = 60000;
+
+/**
+ * Build default board configuration from the tables of a board profile
+ *
+ * @return configuration
+ */
+template <typename Profile>
+static std::shared_ptr<const thermal_config_t> buildDefaultConfig() {
+    static_assert(Profile::kSensorNum <= kMaxSensors && Profile::kCoolingNum <= kMaxCoolingNames,
+                  "board profile tables exceed configuration capacity");
+
+    std::shared_ptr<thermal_config_t> config = std::make_shared<thermal_config_t>();
+
+    config->polling_period_ns = kPollingPeriodNs;
+    config->temperature_mult = kTemperatureMult;
+    config->emergency.action = Profile::kEmergencyAction;
+    config->emergency.severity = Profile::kEmergencyActionSeverity;
+    strcpy(config->uclamp.root, kUclampRoot);
+    config->uclamp.hysteresis = kUclampHysteresis;
+
+    for (int i=1; i < kSeverityNum; i++) {
+        trip_config_t &trip = config->trip[config->nb_trip++];
+        strcpy(trip.trip_type, kSeverityThreshold[i]);
+        trip.severity = static_cast<ThrottlingSeverity>(i);
+    }
+
+    for (int k=0; k < Profile::kSensorNum; k++) {
+        sensor_config_t &sensor = config->sensor[config->nb_sensor++];
+        strcpy(sensor.name, Profile::kSensor[k].name);
+        sensor.type = Profile::kSensor[k].type;
+        strcpy(sensor.zone_type, Profile::kSensor[k].zone_type);
+        for (int i=0; i < kSeverityNum; i++) {
+            sensor.hot_threshold[i] = NAN;
+        }
+    }
+
+    for (int j=0; j < Profile::kCoolingNum; j++) {
+        cooling_config_t &cooling = config->cooling[config->nb_cooling++];
+        strcpy(cooling.name, Profile::kCooling[j].name);
+        cooling.type = Profile::kCooling[j].type;
+        strcpy(cooling.cooling_type, Profile::kCooling[j].cooling_type);
+    }
+
+    return config;
+}
+
+/**
+ * Get back default board configuration
+ *
+ * @return configuration
+ */
+std::shared_ptr<const thermal_config_t> getDefaultConfig() {
+    static const std::shared_ptr<const thermal_config_t> kDefaultConfig = buildDefaultConfig<BoardProfile>();
+
+    return kDefaultConfig;
+}
+
+// Configuration file parsing
+
+/**
+ * Copy a JSON string to a fixed size name
+ *
+ * @return true on success or false if value is not a string or too long.
+ */
+static bool parseName(const Json::Value &value, char *name, size_t size) {
+    if (!value.isString() || value.asString().empty() || value.asString().size() >= size) {
+        return false;
+    }
+    strcpy(name, value.asCString());
+    return true;
+}
+
+/**
+ * Get back a JSON string, values of other types being accessed as an empty string
+ *
+ * @return string
+ */
+static std::string parseString(const Json::Value &value) {
+    return value.isString() ? value.asString() : std::string();
+}
+
+/**
+ * Get back a JSON number, or a default value if not set
+ *
+ * @return true on success or false if value is set but is not a finite number.
+ */
+static bool parseNumber(const Json::Value &value, float default_value, float *number) {
+    if (value.isNull()) {
+        *number = default_value;
+        return true;
+    }
+    if (!value.isNumeric()) {
+        return false;
+    }
+    *number = value.asFloat();
+    return std::isfinite(*number);
+}
+
+static bool parseTemperatureType(const Json::Value &value, TemperatureType *type) {
+    static const struct {
+        const char *name;
+        TemperatureType type;
+    } kTypes[] = {
+        {"UNKNOWN", TemperatureType::UNKNOWN},
+        {"CPU", TemperatureType::CPU},
+        {"GPU", TemperatureType::GPU},
+        {"BATTERY", TemperatureType::BATTERY},
+        {"SKIN", TemperatureType::SKIN},
+        {"USB_PORT", TemperatureType::USB_PORT},
+        {"POWER_AMPLIFIER", TemperatureType::POWER_AMPLIFIER},
+        {"BCL_VOLTAGE", TemperatureType::BCL_VOLTAGE},
+        {"BCL_CURRENT", TemperatureType::BCL_CURRENT},
+        {"BCL_PERCENTAGE", TemperatureType::BCL_PERCENTAGE},
+        {"NPU", TemperatureType::NPU},
+    };
+
+    for (const auto &entry : kTypes) {
+        if (value.isString() && value.asString() == entry.name) {
+            *type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseCoolingType(const Json::Value &value, CoolingType_2_0 *type) {
+    static const struct {
+        const char *name;
+        CoolingType_2_0 type;
+    } kTypes[] = {
+        {"FAN", CoolingType_2_0::FAN},
+        {"BATTERY", CoolingType_2_0::BATTERY},
+        {"CPU", CoolingType_2_0::CPU},
+        {"GPU", CoolingType_2_0::GPU},
+        {"MODEM", CoolingType_2_0::MODEM},
+        {"NPU", CoolingType_2_0::NPU},
+        {"COMPONENT", CoolingType_2_0::COMPONENT},
+    };
+
+    for (const auto &entry : kTypes) {
+        if (value.isString() && value.asString() == entry.name) {
+            *type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseSeverity(const Json::Value &value, ThrottlingSeverity *severity) {
+    static const char *kSeverityName[kSeverityNum] =
+        {"NONE", "LIGHT", "MODERATE", "SEVERE", "CRITICAL", "EMERGENCY", "SHUTDOWN"};
+
+    for (int i=0; i < kSeverityNum; i++) {
+        if (value.isString() && value.asString() == kSeverityName[i]) {
+            *severity = static_cast<ThrottlingSeverity>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseEmergency(const Json::Value &value, emergency_config_t *emergency) {
+    const std::string action = value["Action"].isNull() ? "NONE" : parseString(value["Action"]);
+
+    if (action == "NONE") {
+        emergency->action = EmergencyAction::NONE;
+    } else if (action == "SHUTDOWN") {
+        emergency->action = EmergencyAction::SHUTDOWN;
+    } else {
+        LOG(ERROR) << "parseThermalConfig: invalid emergency action " << action;
+        return false;
+    }
+
+    // Action is only taken by the emergency path
+    if (!value["Severity"].isNull() &&
+        (!parseSeverity(value["Severity"], &emergency->severity) ||
+         emergency->severity < ThrottlingSeverity::EMERGENCY)) {
+        LOG(ERROR) << "parseThermalConfig: invalid emergency severity";
+        return false;
+    }
+
+    return true;
+}
+
+static bool parseUclamp(const Json::Value &value, uclamp_config_t *uclamp) {
+    const Json::Value &root = value["Root"];
+    if (!root.isNull() && !parseName(root, uclamp->root, sizeof(uclamp->root))) {
+        LOG(ERROR) << "parseThermalConfig: invalid uclamp root";
+        return false;
+    }
+
+    if (!parseNumber(value["Hysteresis"], kUclampHysteresis, &uclamp->hysteresis) || uclamp->hysteresis < 0) {
+        LOG(ERROR) << "parseThermalConfig: invalid uclamp hysteresis";
+        return false;
+    }
+
+    const Json::Value &groups = value["Groups"];
+    if (!groups.isArray() || groups.size() > kMaxUclampGroups) {
+        LOG(ERROR) << "parseThermalConfig: invalid uclamp groups";
+        return false;
+    }
+    for (const Json::Value &group : groups) {
+        uclamp_group_t &entry = uclamp->group[uclamp->nb_group++];
+        if (!group.isObject() || !parseName(group["Path"], entry.path, sizeof(entry.path)) ||
+            entry.path[0] == '/' || strstr(entry.path, "..") != nullptr) {
+            LOG(ERROR) << "parseThermalConfig: invalid uclamp group path";
+            return false;
+        }
+        const Json::Value &uclamp_max = group["UclampMax"];
+        if (!uclamp_max.isArray() || uclamp_max.size() != kSeverityNum) {
+            LOG(ERROR) << "parseThermalConfig: expecting " << kSeverityNum
+                       << " uclamp max for group " << entry.path;
+            return false;
+        }
+        for (int i=0; i < kSeverityNum; i++) {
+            if (!uclamp_max[i].isNumeric() || !parseNumber(uclamp_max[i], NAN, &entry.uclamp_max[i]) ||
+                entry.uclamp_max[i] < 0 || entry.uclamp_max[i] > 100) {
+                LOG(ERROR) << "parseThermalConfig: invalid uclamp max for group " << entry.path;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool parseFilter(const Json::Value &value, filter_config_t *filter) {
+    const std::string type = parseString(value["Type"]);
+
+    // Parameters have no default value
+    if (type == "NONE") {
+        filter->type = FilterType::NONE;
+    } else if (type == "EWMA") {
+        filter->type = FilterType::EWMA;
+        return parseNumber(value["Alpha"], NAN, &filter->alpha) && filter->alpha > 0 && filter->alpha <= 1;
+    } else if (type == "KALMAN") {
+        filter->type = FilterType::KALMAN;
+        return parseNumber(value["ProcessNoise"], NAN, &filter->process_noise) &&
+               parseNumber(value["MeasurementNoise"], NAN, &filter->measurement_noise) &&
+               filter->process_noise > 0 && filter->measurement_noise > 0;
+    } else if (type == "MEDIAN") {
+        filter->type = FilterType::MEDIAN;
+        if (!value["Window"].isInt()) {
+            return false;
+        }
+        filter->window = value["Window"].asInt();
+        return filter->window > 0 && filter->window <= kMaxFilterWindow;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Find a sensor by name
+ *
+ * @return index of sensor or -1 if not found
+ */
+static int findSensor(const thermal_config_t &config, const std::string &name) {
+    for (int k=0; k < config.nb_sensor; k++) {
+        if (name == config.sensor[k].name) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+static bool parseSensor(const Json::Value &value, sensor_config_t *sensor) {
+    if (!value.isObject() || !parseName(value["Name"], sensor->name, sizeof(sensor->name))) {
+        LOG(ERROR) << "parseThermalConfig: invalid sensor name";
+        return false;
+    }
+    if (!parseTemperatureType(value["Type"], &sensor->type)) {
+        LOG(ERROR) << "parseThermalConfig: invalid type for sensor " << sensor->name;
+        return false;
+    }
+
+    sensor->is_virtual = value.isMember("Virtual");
+    if (!sensor->is_virtual &&
+        !parseName(value["ZoneType"], sensor->zone_type, sizeof(sensor->zone_type))) {
+        LOG(ERROR) << "parseThermalConfig: invalid zone type for sensor " << sensor->name;
+        return false;
+    }
+
+    for (int i=0; i < kSeverityNum; i++) {
+        sensor->hot_threshold[i] = NAN;
+    }
+    const Json::Value &thresholds = value["HotThresholds"];
+    if (!thresholds.isNull()) {
+        if (!thresholds.isArray() || thresholds.size() != kSeverityNum) {
+            LOG(ERROR) << "parseThermalConfig: expecting " << kSeverityNum
+                       << " hot thresholds for sensor " << sensor->name;
+            return false;
+        }
+        for (int i=0; i < kSeverityNum; i++) {
+            if (!parseNumber(thresholds[i], NAN, &sensor->hot_threshold[i])) {
+                LOG(ERROR) << "parseThermalConfig: invalid hot threshold for sensor " << sensor->name;
+                return false;
+            }
+        }
+    }
+
+    const Json::Value &filter = value["Filter"];
+    if (!filter.isNull() && (!filter.isObject() || !parseFilter(filter, &sensor->filter))) {
+        LOG(ERROR) << "parseThermalConfig: invalid filter for sensor " << sensor->name;
+        return false;
+    }
+
+    return true;
+}
+
+static bool parseVirtualSensor(const Json::Value &value, const thermal_config_t &config,
+                               sensor_config_t *sensor) {
+    virtual_sensor_t &virtual_sensor = sensor->virtual_sensor;
+
+    if (!value.isObject()) {
+        LOG(ERROR) << "parseThermalConfig: invalid virtual sensor " << sensor->name;
+        return false;
+    }
+    const std::string combination = parseString(value["Combination"]);
+    const Json::Value &inputs = value["Inputs"];
+    const Json::Value &weights = value["Weights"];
+
+    if (combination == "WEIGHTED_SUM") {
+        virtual_sensor.combination = VirtualCombination::WEIGHTED_SUM;
+    } else if (combination == "MAX") {
+        virtual_sensor.combination = VirtualCombination::MAX;
+    } else if (combination == "MIN") {
+        virtual_sensor.combination = VirtualCombination::MIN;
+    } else {
+        LOG(ERROR) << "parseThermalConfig: invalid combination for sensor " << sensor->name;
+        return false;
+    }
+
+    if (!inputs.isArray() || inputs.size() == 0 || inputs.size() > kMaxVirtualInputs ||
+        (!weights.isNull() && (!weights.isArray() || weights.size() != inputs.size()))) {
+        LOG(ERROR) << "parseThermalConfig: invalid inputs for sensor " << sensor->name;
+        return false;
+    }
+
+    virtual_sensor.nb_input = inputs.size();
+    for (int i=0; i < virtual_sensor.nb_input; i++) {
+        int input = inputs[i].isString() ? findSensor(config, inputs[i].asString()) : -1;
+        // Virtual sensors are computed from physical sensors only
+        if (input < 0 || config.sensor[input].is_virtual) {
+            LOG(ERROR) << "parseThermalConfig: invalid input " << parseString(inputs[i])
+                       << " for sensor " << sensor->name;
+            return false;
+        }
+        virtual_sensor.input[i] = input;
+        virtual_sensor.weight[i] = 1.0;
+        if (!weights.isNull() &&
+            (!weights[i].isNumeric() || !parseNumber(weights[i], NAN, &virtual_sensor.weight[i]))) {
+            LOG(ERROR) << "parseThermalConfig: invalid weight for sensor " << sensor->name;
+            return false;
+        }
+    }
+    if (!parseNumber(value["Offset"], 0, &virtual_sensor.offset)) {
+        LOG(ERROR) << "parseThermalConfig: invalid offset for sensor " << sensor->name;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Parse and validate a board configuration file
+ *
+ * @param config_path Path of the configuration file
+ *
+ * @return configuration, or nullptr on error.
+ */
+std::shared_ptr<const thermal_config_t> parseThermalConfig(const std::string &config_path) {
+    std::shared_ptr<thermal_config_t> config = std::make_shared<thermal_config_t>();
+    Json::CharReaderBuilder builder;
+    Json::Value root;
+    std::string errors;
+
+    std::ifstream stream(config_path);
+    if (!stream.is_open()) {
+        return nullptr;
+    }
+    if (!Json::parseFromStream(builder, stream, &root, &errors)) {
+        LOG(ERROR) << "parseThermalConfig: failed to parse " << config_path << ": " << errors;
+        return nullptr;
+    }
+
+    // Members of values of any other type can't be accessed
+    if (!root.isObject()) {
+        LOG(ERROR) << "parseThermalConfig: " << config_path << " is not a JSON object";
+        return nullptr;
+    }
+
+    const Json::Value &period = root["PollingPeriodMs"];
+    int64_t period_ms = period.isInt64() ? period.asInt64() : kPollingPeriodNs / 1000000;
+    if ((!period.isNull() && !period.isInt64()) ||
+        period_ms < kMinPollingPeriodMs || period_ms > kMaxPollingPeriodMs) {
+        LOG(ERROR) << "parseThermalConfig: invalid polling period";
+        return nullptr;
+    }
+    config->polling_period_ns = period_ms * 1000000LL;
+
+    // Temperatures would all be 0, or inverted
+    if (!parseNumber(root["TemperatureMultiplier"], kTemperatureMult, &config->temperature_mult) ||
+        config->temperature_mult <= 0) {
+        LOG(ERROR) << "parseThermalConfig: invalid temperature multiplier";
+        return nullptr;
+    }
+
+    config->emergency.action = EmergencyAction::NONE;
+    config->emergency.severity = ThrottlingSeverity::SHUTDOWN;
+    const Json::Value &emergency = root["Emergency"];
+    if (!emergency.isNull() && (!emergency.isObject() || !parseEmergency(emergency, &config->emergency))) {
+        return nullptr;
+    }
+
+    strcpy(config->uclamp.root, kUclampRoot);
+    config->uclamp.hysteresis = kUclampHysteresis;
+    const Json::Value &uclamp = root["UclampAdvisor"];
+    if (!uclamp.isNull() && (!uclamp.isObject() || !parseUclamp(uclamp, &config->uclamp))) {
+        return nullptr;
+    }
+
+    const Json::Value &trips = root["TripSeverity"];
+    if (!trips.isObject() || trips.size() > kMaxTripTypes) {
+        LOG(ERROR) << "parseThermalConfig: invalid trip severities";
+        return nullptr;
+    }
+    for (const std::string &trip_type : trips.getMemberNames()) {
+        trip_config_t &trip = config->trip[config->nb_trip++];
+        if (!parseName(Json::Value(trip_type), trip.trip_type, sizeof(trip.trip_type)) ||
+            !parseSeverity(trips[trip_type], &trip.severity)) {
+            LOG(ERROR) << "parseThermalConfig: invalid severity for trip " << trip_type;
+            return nullptr;
+        }
+    }
+
+    const Json::Value &sensors = root["Sensors"];
+    if (!sensors.isArray() || sensors.size() > kMaxSensors) {
+        LOG(ERROR) << "parseThermalConfig: invalid sensors";
+        return nullptr;
+    }
+    for (const Json::Value &value : sensors) {
+        sensor_config_t &sensor = config->sensor[config->nb_sensor];
+        if (!parseSensor(value, &sensor)) {
+            return nullptr;
+        }
+        if (findSensor(*config, sensor.name) >= 0) {
+            LOG(ERROR) << "parseThermalConfig: duplicated sensor " << sensor.name;
+            return nullptr;
+        }
+        config->nb_sensor++;
+    }
+    // Virtual sensor inputs may be declared after the virtual sensor itself
+    for (int k=0; k < config->nb_sensor; k++) {
+        if (config->sensor[k].is_virtual &&
+            !parseVirtualSensor(sensors[k]["Virtual"], *config, &config->sensor[k])) {
+            return nullptr;
+        }
+    }
+
+    const Json::Value &coolings = root["CoolingDevices"];
+    if (!coolings.isArray() || coolings.size() > kMaxCoolingNames) {
+        LOG(ERROR) << "parseThermalConfig: invalid cooling devices";
+        return nullptr;
+    }
+    for (const Json::Value &value : coolings) {
+        cooling_config_t &cooling = config->cooling[config->nb_cooling++];
+        if (!value.isObject() || !parseName(value["Name"], cooling.name, sizeof(cooling.name)) ||
+            !parseCoolingType(value["Type"], &cooling.type) ||
+            !parseName(value["CoolingType"], cooling.cooling_type, sizeof(cooling.cooling_type))) {
+            LOG(ERROR) << "parseThermalConfig: invalid cooling device " << config->nb_cooling - 1;
+            return nullptr;
+        }
+    }
+
+    return config;
+}
+
+/**
+ * Get back path of board configuration file
+ *
+ * @return path
+ */
+std::string getThermalConfigPath() {
+    return android::base::GetProperty(kThermalConfigProperty, kThermalConfigFile);
+}
+
+/**
+ * Load board configuration file, or default configuration if not available
+ *
+ * @return configuration
+ */
+std::shared_ptr<const thermal_config_t> loadThermalConfig() {
+    // Configuration is fixed at compile time by production board profiles
+    if constexpr (!BoardProfile::kRuntimeConfig) {
+        return getDefaultConfig();
+    }
+
+    std::string config_path = getThermalConfigPath();
+    std::shared_ptr<const thermal_config_t> config = parseThermalConfig(config_path);
+
+    if (config == nullptr) {
+        LOG(INFO) << "loadThermalConfig: no valid " << config_path << ", use default configuration";
+        return getDefaultConfig();
+    }
+    LOG(INFO) << "loadThermalConfig: " << config->nb_sensor << " sensors, " << config->nb_cooling
+              << " cooling devices from " << config_path;
+    return config;
+}
+
+/**
+ * Compute checksum of a configuration, configurations being
+ * zero filled before being set
+ *
+ * @return checksum
+ */
+uint32_t getConfigChecksum(const thermal_config_t &config) {
+    return getChecksum(&config, sizeof(config));
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_CONFIG_H__
+#define __THERMAL_CONFIG_H__
+
+#include <memory>
+#include <string>
+
+#include <android/hardware/thermal/2.0/IThermal.h>
+
+#include "thermal-profile.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::hardware::thermal::V2_0::ThrottlingSeverity;
+
+// Board configuration file, path can be overridden by property
+constexpr const char *kThermalConfigFile = "/vendor/etc/thermal-config.json";
+constexpr const char *kThermalConfigProperty = "ro.vendor.thermal.config";
+
+// Maximum number of sensors (physical and virtual) described by a configuration
+constexpr unsigned int kMaxSensors = BoardProfile::kMaxSensors;
+
+// Maximum number of cooling devices described by a configuration
+constexpr unsigned int kMaxCoolingNames = BoardProfile::kMaxCoolingNames;
+
+// Maximum number of kernel trip types associated with a severity
+constexpr unsigned int kMaxTripTypes = 8;
+
+// Maximum number of physical sensors a virtual sensor is computed from
+constexpr unsigned int kMaxVirtualInputs = 4;
+
+/* ThrottlingSeverity: NONE, LIGHT, MODERATE, SEVERE, CRITICAL, EMERGENCY, SHUTDOWN */
+constexpr const int kSeverityNum = static_cast<int>(ThrottlingSeverity::SHUTDOWN) + 1;
+
+// Maximum number of reads a median filter is computed from
+constexpr unsigned int kMaxFilterWindow = 9;
+
+enum class FilterType : uint32_t {
+    NONE,
+    EWMA,           // exponentially weighted moving average
+    KALMAN,         // scalar Kalman filter, temperature modeled as a random walk
+    MEDIAN,         // median of last reads
+};
+
+struct filter_config_t {
+    FilterType          type;
+    float               alpha;                      // EWMA: weight of a new read, 0 to 1
+    float               process_noise;              // KALMAN: variance added between two reads
+    float               measurement_noise;          // KALMAN: variance of a read
+    int                 window;                     // MEDIAN: number of reads
+};
+
+enum class VirtualCombination : uint32_t {
+    WEIGHTED_SUM,   // sum of weight * input, plus offset
+    MAX,            // maximum of inputs, plus offset
+    MIN,            // minimum of inputs, plus offset
+};
+
+struct virtual_sensor_t {
+    VirtualCombination  combination;
+    int                 nb_input;
+    int                 input[kMaxVirtualInputs];   // index in physical sensors
+    float               weight[kMaxVirtualInputs];
+    float               offset;
+};
+
+struct sensor_config_t {
+    char                name[32];
+    TemperatureType     type;
+    bool                is_virtual;
+    char                zone_type[32];              // physical sensor: kernel thermal zone type
+    virtual_sensor_t    virtual_sensor;
+    float               hot_threshold[kSeverityNum];    // NAN: value of kernel trip, if any
+    filter_config_t     filter;
+};
+
+struct cooling_config_t {
+    char                name[32];
+    CoolingType_2_0     type;
+    char                cooling_type[32];           // kernel cooling device type
+};
+
+struct trip_config_t {
+    char                trip_type[32];              // kernel trip type
+    ThrottlingSeverity  severity;
+};
+
+struct emergency_config_t {
+    EmergencyAction     action;
+    ThrottlingSeverity  severity;                   // EMERGENCY or SHUTDOWN
+};
+
+// Maximum number of cgroups driven by the uclamp advisor
+constexpr unsigned int kMaxUclampGroups = 4;
+
+struct uclamp_group_t {
+    char                path[32];                   // relative to cgroup root
+    float               uclamp_max[kSeverityNum];   // percentage, per severity
+};
+
+// Soft cooling: cap utilization of cgroups before kernel cooling engages
+struct uclamp_config_t {
+    char                root[64];                   // cgroup root, e.g. /dev/cpuctl
+    float               hysteresis;                 // Celsius, to leave a severity
+    int                 nb_group;                   // 0: disabled
+    uclamp_group_t      group[kMaxUclampGroups];
+};
+
+// Board configuration, flat and never modified once published
+struct thermal_config_t {
+    int64_t             polling_period_ns;
+    float               temperature_mult;           // kernel unit to Celsius
+    emergency_config_t  emergency;
+    uclamp_config_t     uclamp;
+    int                 nb_trip;
+    trip_config_t       trip[kMaxTripTypes];
+    int                 nb_sensor;
+    sensor_config_t     sensor[kMaxSensors];
+    int                 nb_cooling;
+    cooling_config_t    cooling[kMaxCoolingNames];
+};
+
+std::string getThermalConfigPath();
+std::shared_ptr<const thermal_config_t> getDefaultConfig();
+std::shared_ptr<const thermal_config_t> parseThermalConfig(const std::string &config_path);
+std::shared_ptr<const thermal_config_t> loadThermalConfig();
+
+uint32_t getConfigChecksum(const thermal_config_t &config);
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_CONFIG_H__
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include <sched.h>
+
+#include <android-base/logging.h>
+#include <android-base/properties.h>
+#include <utils/SystemClock.h>
+
+#include "thermal-emergency.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+EmergencyHandler::EmergencyHandler(std::function<void(const Temperature_2_0 &)> notify)
+    : notify_(notify), stop_(false), pending_timestamp_(0), action_pending_(false), action_done_(false),
+      stats_() {
+    // Room for one event per sensor, so that queue is not grown while sampling
+    pending_.reserve(kMaxSensors);
+}
+
+EmergencyHandler::~EmergencyHandler() {
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> _lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+}
+
+/**
+ * Start emergency thread
+ *
+ * @return true on success or false on error.
+ */
+bool EmergencyHandler::start() {
+    thread_ = std::thread(&EmergencyHandler::emergencyLoop, this);
+    return true;
+}
+
+/**
+ * Check a new sample, sampling being serialized by gSnapshotMutex
+ *
+ * Only sensors entering EMERGENCY or SHUTDOWN severity wake the emergency
+ * thread, a sample without any change costing a single pass on sensors.
+ *
+ * @param snapshot New sample
+ */
+void EmergencyHandler::check(const thermal_snapshot_t &snapshot) {
+    const thermal_config_t &config = *snapshot.config;
+    bool event = false;
+    bool action = false;
+
+    std::lock_guard<std::mutex> _lock(notified_mutex_);
+    resetNotified(snapshot);
+
+    // Lower severities are left to the monitor thread
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        ThrottlingSeverity severity = sample.severity;
+        if (severity < kEmergencySeverity || severity == notified_[sample.name]) {
+            continue;
+        }
+        notified_[sample.name] = severity;
+        notified_timestamp_[sample.name] = snapshot.timestamp;
+
+        if (!event) {
+            mutex_.lock();
+            event = true;
+        }
+        const sensor_config_t &sensor = config.sensor[sample.name];
+        if (pending_.empty()) {
+            pending_timestamp_ = snapshot.timestamp;
+        }
+        pending_.push_back({sensor.type, sensor.name, sample.value, severity});
+        if (config.emergency.action != EmergencyAction::NONE && severity >= config.emergency.severity) {
+            action = true;
+        }
+    }
+
+    if (event) {
+        action_pending_ |= action;
+        mutex_.unlock();
+        cv_.notify_all();
+    }
+}
+
+/**
+ * Fill temperature of sensors whose severity changed since last notified, by
+ * either path, and account them as notified (monitor thread)
+ *
+ * Emergency severities of the snapshot were already handled by check().
+ *
+ * @param snapshot Last sample of monitor thread
+ * @param temperatures Pointer to temperature data
+ *
+ * @return number of data returned
+ */
+ssize_t EmergencyHandler::fillThrottlingChanges(const thermal_snapshot_t &snapshot,
+                                                hidl_vec<Temperature_2_0> *temperatures) {
+    std::lock_guard<std::mutex> _lock(notified_mutex_);
+    ThrottlingSeverity notified[kMaxSensors];
+
+    resetNotified(snapshot);
+    std::copy(notified_, notified_ + kMaxSensors, notified);
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        // Sensors notified from a newer sample of another thread are not changed back
+        if (notified_timestamp_[sample.name] > snapshot.timestamp) {
+            notified[sample.name] = sample.severity;
+            continue;
+        }
+        notified_[sample.name] = sample.severity;
+        notified_timestamp_[sample.name] = snapshot.timestamp;
+    }
+
+    return implementation::fillThrottlingChanges(notified, snapshot, temperatures);
+}
+
+/**
+ * Reset notified severities on configuration change, severities being
+ * tracked per configured sensor (notified_mutex_ held)
+ *
+ * @param snapshot New sample
+ */
+void EmergencyHandler::resetNotified(const thermal_snapshot_t &snapshot) {
+    if (config_ != snapshot.config) {
+        config_ = snapshot.config;
+        std::fill(notified_, notified_ + kMaxSensors, ThrottlingSeverity::NONE);
+        std::fill(notified_timestamp_, notified_timestamp_ + kMaxSensors, 0);
+    }
+}
+
+/**
+ * Get back emergency path instrumentation
+ *
+ * @return statistics
+ */
+emergency_stats_t EmergencyHandler::getStats() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    return stats_;
+}
+
+void EmergencyHandler::emergencyLoop() {
+    std::vector<Temperature_2_0> events;
+    struct sched_param param = {.sched_priority = kEmergencyThreadPriority};
+
+    // Emergency must not wait for routine threads, binder ones included
+    if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+        PLOG(WARNING) << "EmergencyHandler: failed to set real-time priority";
+    }
+    events.reserve(kMaxSensors);
+
+    std::unique_lock<std::mutex> _lock(mutex_);
+    while (true) {
+        cv_.wait(_lock, [this] { return stop_ || !pending_.empty(); });
+        if (stop_) {
+            return;
+        }
+        events.swap(pending_);
+        int64_t timestamp = pending_timestamp_;
+        bool action = action_pending_ && !action_done_;
+        action_pending_ = false;
+        action_done_ |= action;
+        _lock.unlock();
+
+        // Subscribers first, notifications being oneway
+        for (const Temperature_2_0 &temperature : events) {
+            LOG(ERROR) << "Emergency: " << temperature.name << " at " << temperature.value << " C, severity "
+                       << android::hardware::thermal::V2_0::toString(temperature.throttlingStatus);
+            notify_(temperature);
+        }
+        int64_t notify_latency = elapsedRealtimeNano() - timestamp;
+
+        int64_t action_latency = 0;
+        if (action) {
+            LOG(ERROR) << "Emergency: requesting shutdown";
+            if (!android::base::SetProperty(kShutdownProperty, kShutdownReason)) {
+                LOG(ERROR) << "Emergency: failed to request shutdown";
+            }
+            action_latency = elapsedRealtimeNano() - timestamp;
+        }
+
+        int64_t latency = action ? action_latency : notify_latency;
+        LOG(INFO) << "Emergency: handled " << latency / 1000 << " us after sample";
+        if (latency > kEmergencyLatencyBudgetNs) {
+            LOG(WARNING) << "Emergency: latency above " << kEmergencyLatencyBudgetNs / 1000000 << " ms budget";
+        }
+
+        _lock.lock();
+        stats_.nb_event += events.size();
+        stats_.last_notify_latency_ns = notify_latency;
+        stats_.max_notify_latency_ns = std::max(stats_.max_notify_latency_ns, notify_latency);
+        if (action) {
+            stats_.nb_action++;
+            stats_.last_action_latency_ns = action_latency;
+            stats_.max_action_latency_ns = std::max(stats_.max_action_latency_ns, action_latency);
+        }
+        if (latency > kEmergencyLatencyBudgetNs) {
+            stats_.nb_overrun++;
+        }
+        events.clear();
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
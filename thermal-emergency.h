@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_EMERGENCY_H__
+#define __THERMAL_EMERGENCY_H__
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Severity from which a sensor is handled by the emergency path
+constexpr ThrottlingSeverity kEmergencySeverity = ThrottlingSeverity::EMERGENCY;
+
+// Sample to action latency above which an overrun is reported
+constexpr int64_t kEmergencyLatencyBudgetNs = 50000000LL;
+
+// Real-time priority of emergency thread (SCHED_FIFO)
+constexpr int kEmergencyThreadPriority = 50;
+
+// Orderly shutdown request
+constexpr const char *kShutdownProperty = "sys.powerctl";
+constexpr const char *kShutdownReason = "shutdown,thermal";
+
+// Instrumentation of the emergency path, latencies being counted from sample
+struct emergency_stats_t {
+    uint32_t    nb_event;               // sensors entering EMERGENCY or SHUTDOWN
+    uint32_t    nb_action;
+    uint32_t    nb_overrun;             // latency above kEmergencyLatencyBudgetNs
+    int64_t     last_notify_latency_ns;
+    int64_t     max_notify_latency_ns;
+    int64_t     last_action_latency_ns;
+    int64_t     max_action_latency_ns;
+};
+
+// Handles sensors reaching EMERGENCY or SHUTDOWN severity on a dedicated
+// real-time thread, woken by sampling itself: subscribers are notified and
+// configured action is taken without waiting for the monitor thread, nor for
+// any routine notification. Last notified severities are shared with the
+// monitor thread, which notifies routine changes against them: a drop from
+// EMERGENCY seen by a sample of the monitor is notified even if the emergency
+// was raised by a sample of another thread.
+class EmergencyHandler {
+  public:
+    explicit EmergencyHandler(std::function<void(const Temperature_2_0 &)> notify);
+    ~EmergencyHandler();
+
+    bool start();
+    void check(const thermal_snapshot_t &snapshot);
+    ssize_t fillThrottlingChanges(const thermal_snapshot_t &snapshot, hidl_vec<Temperature_2_0> *temperatures);
+
+    emergency_stats_t getStats();
+
+  private:
+    void emergencyLoop();
+    void resetNotified(const thermal_snapshot_t &snapshot);
+
+    std::function<void(const Temperature_2_0 &)> notify_;
+    // Last notified severity of configured sensors, by either path, and
+    // timestamp of the sample it was notified from
+    std::mutex notified_mutex_;
+    std::shared_ptr<const thermal_config_t> config_;
+    ThrottlingSeverity notified_[kMaxSensors];
+    int64_t notified_timestamp_[kMaxSensors];
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_;
+    std::vector<Temperature_2_0> pending_;
+    int64_t pending_timestamp_;     // sample of the oldest pending event
+    bool action_pending_;
+    bool action_done_;
+    emergency_stats_t stats_;
+    std::thread thread_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_EMERGENCY_H__
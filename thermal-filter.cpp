@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "thermal-filter.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+/**
+ * Reset filter state, next read being used as is
+ *
+ * @param state Filter state
+ */
+void resetFilter(filter_state_t *state) {
+    memset(state, 0, sizeof(filter_state_t));
+}
+
+/**
+ * Median of the reads held by a median filter
+ *
+ * @return median, lower one if the number of reads is even (filter warming up)
+ */
+static float getMedian(const filter_state_t &state) {
+    float value[kMaxFilterWindow];
+    int n = state.nb_value;
+
+    std::copy(state.value, state.value + n, value);
+    std::sort(value, value + n);
+    return value[(n - 1) / 2];
+}
+
+/**
+ * Filter a new read of a sensor
+ *
+ * @param config Filter configuration of the sensor
+ * @param state Filter state of the sensor
+ * @param value New read, in Celsius
+ *
+ * @return filtered value
+ */
+float applyFilter(const filter_config_t &config, filter_state_t *state, float value) {
+    switch (config.type) {
+        case FilterType::EWMA:
+            state->estimate = state->initialized ?
+                config.alpha * value + (1 - config.alpha) * state->estimate : value;
+            break;
+
+        case FilterType::KALMAN:
+            if (!state->initialized) {
+                state->estimate = value;
+                state->variance = config.measurement_noise;
+            } else {
+                // Predict (temperature unchanged, uncertainty grows), then correct with read
+                float variance = state->variance + config.process_noise;
+                float gain = variance / (variance + config.measurement_noise);
+                state->estimate += gain * (value - state->estimate);
+                state->variance = (1 - gain) * variance;
+            }
+            break;
+
+        case FilterType::MEDIAN:
+            state->value[state->next] = value;
+            state->next = (state->next + 1) % config.window;
+            state->nb_value = std::min(state->nb_value + 1, config.window);
+            state->estimate = getMedian(*state);
+            break;
+
+        case FilterType::NONE:
+        default:
+            state->estimate = value;
+            break;
+    }
+    state->initialized = true;
+
+    return state->estimate;
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_FILTER_H__
+#define __THERMAL_FILTER_H__
+
+#include "thermal-config.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// State of the filter of a sensor, same footprint whatever the filter
+struct filter_state_t {
+    bool                initialized;
+    float               estimate;                   // EWMA, KALMAN
+    float               variance;                   // KALMAN: variance of estimate
+    int                 nb_value;                   // MEDIAN: reads held, up to window
+    int                 next;                       // MEDIAN: oldest read, replaced by next one
+    float               value[kMaxFilterWindow];    // MEDIAN
+};
+
+void resetFilter(filter_state_t *state);
+float applyFilter(const filter_config_t &config, filter_state_t *state, float value);
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_FILTER_H__
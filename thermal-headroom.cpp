@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cinttypes>
+#include <cmath>
+
+#include <android-base/stringprintf.h>
+
+#include "thermal-headroom.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::StringAppendF;
+
+HeadroomEstimator::HeadroomEstimator()
+    : timestamp_(),
+      value_(),
+      slope_() {}
+
+/**
+ * Update trends with a periodic sample, and publish headroom table
+ *
+ * @param snapshot New sample, newer than all previous ones
+ */
+void HeadroomEstimator::update(const thermal_snapshot_t &snapshot) {
+    std::shared_ptr<headroom_table_t> table = std::make_shared<headroom_table_t>();
+
+    // Trends are kept per configured sensor, and restarted on configuration change
+    if (config_ != snapshot.config) {
+        config_ = snapshot.config;
+        for (int k=0; k < kMaxSensors; k++) {
+            timestamp_[k] = 0;
+        }
+    }
+
+    table->config = snapshot.config;
+    table->timestamp = snapshot.timestamp;
+    table->nb_sensor = 0;
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        const TemperatureThreshold &threshold = snapshot.thresholds->all[sample.sensor];
+        int name = sample.name;
+
+        if (timestamp_[name] == 0 || snapshot.timestamp <= timestamp_[name]) {
+            slope_[name] = 0;
+        } else {
+            float slope = (sample.value - value_[name]) * 1e9 / (snapshot.timestamp - timestamp_[name]);
+            slope_[name] += kHeadroomSlopeAlpha * (slope - slope_[name]);
+        }
+        timestamp_[name] = snapshot.timestamp;
+        value_[name] = sample.value;
+
+        sensor_headroom_t &headroom = table->sensor[table->nb_sensor++];
+        headroom.name = name;
+        headroom.type = threshold.type;
+        headroom.value = sample.value;
+        headroom.slope = slope_[name];
+        headroom.severity = sample.severity;
+        headroom.next_severity = sample.severity;
+        headroom.threshold = NAN;
+        for (int s = static_cast<int>(sample.severity) + 1; s < kSeverityNum; s++) {
+            if (!std::isnan(threshold.hotThrottlingThresholds[s])) {
+                headroom.next_severity = static_cast<ThrottlingSeverity>(s);
+                headroom.threshold = threshold.hotThrottlingThresholds[s];
+                break;
+            }
+        }
+    }
+
+    std::atomic_store(&table_, std::shared_ptr<const headroom_table_t>(table));
+}
+
+/**
+ * Restart trends from next sample, so that no slope spans a time without sample:
+ * the first table published after is forecast with a slope of 0
+ */
+void HeadroomEstimator::restart() {
+    for (int k=0; k < kMaxSensors; k++) {
+        timestamp_[k] = 0;
+    }
+}
+
+/**
+ * Get back headroom of sensors of last sample
+ *
+ * @param filter_type true if only sensors of type are returned
+ * @param type Temperature type, if filter_type
+ * @param forecast_ms Forecast horizon from last sample, in ms
+ * @param headrooms Pointer to headrooms, in sensor order
+ *
+ * @return true on success or false if no sample was taken yet.
+ */
+bool HeadroomEstimator::getHeadroom(bool filter_type, TemperatureType type, uint32_t forecast_ms,
+                                    hidl_vec<TemperatureHeadroom> *headrooms) {
+    std::shared_ptr<const headroom_table_t> table = std::atomic_load(&table_);
+    size_t num = 0;
+
+    if (table == nullptr) {
+        headrooms->resize(0);
+        return false;
+    }
+
+    headrooms->resize(table->nb_sensor);
+    for (int i=0; i < table->nb_sensor; i++) {
+        const sensor_headroom_t &sensor = table->sensor[i];
+        if (filter_type && sensor.type != type) {
+            continue;
+        }
+        TemperatureHeadroom &out = (*headrooms)[num++];
+        out.name = table->config->sensor[sensor.name].name;
+        out.type = sensor.type;
+        out.timestamp = table->timestamp;
+        out.value = sensor.value;
+        out.slope = sensor.slope;
+        out.severity = sensor.severity;
+        out.nextSeverity = sensor.next_severity;
+        out.threshold = sensor.threshold;
+        out.headroom = sensor.threshold - (sensor.value + sensor.slope * forecast_ms / 1000);
+        out.timeToThresholdMs = -1;
+        if (!std::isnan(sensor.threshold) && sensor.slope > 0) {
+            out.timeToThresholdMs = static_cast<int64_t>((sensor.threshold - sensor.value) * 1000 / sensor.slope);
+        }
+    }
+    headrooms->resize(num);
+    return true;
+}
+
+/**
+ * Dump headroom of sensors of last sample
+ *
+ * @param out Pointer to dump, appended
+ */
+void HeadroomEstimator::dump(std::string *out) {
+    hidl_vec<TemperatureHeadroom> headrooms;
+
+    getHeadroom(false, TemperatureType::UNKNOWN, 0, &headrooms);
+    for (const TemperatureHeadroom &headroom : headrooms) {
+        StringAppendF(out, "Headroom %s: %.1f, slope %.3f/s, %.1f to severity %d (%.1f), %" PRId64 " ms"
+                      " (sample at %" PRId64 " ns)\n",
+                      headroom.name.c_str(), headroom.value, headroom.slope, headroom.headroom,
+                      static_cast<int>(headroom.nextSeverity), headroom.threshold, headroom.timeToThresholdMs,
+                      headroom.timestamp);
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
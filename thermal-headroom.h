@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_HEADROOM_H__
+#define __THERMAL_HEADROOM_H__
+
+#include <memory>
+#include <string>
+
+#include <vendor/stm32mpu/hardware/thermal/1.0/types.h>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::vendor::stm32mpu::hardware::thermal::V1_0::TemperatureHeadroom;
+
+// Smoothing factor of the temperature trend, applied at each sample
+constexpr float kHeadroomSlopeAlpha = 0.2;
+
+// Trend of sensors and their next hot threshold, computed at each periodic
+// sample. Each sample publishes an immutable table: clients forecast from it
+// without lock nor sensor read.
+class HeadroomEstimator {
+  public:
+    HeadroomEstimator();
+
+    void update(const thermal_snapshot_t &snapshot);
+    void restart();
+    bool getHeadroom(bool filter_type, TemperatureType type, uint32_t forecast_ms,
+                     hidl_vec<TemperatureHeadroom> *headrooms);
+    void dump(std::string *out);
+
+  private:
+    struct sensor_headroom_t {
+        int                 name;           // index in configured sensors
+        TemperatureType     type;
+        float               value;
+        float               slope;          // in Celsius per second
+        ThrottlingSeverity  severity;
+        ThrottlingSeverity  next_severity;
+        float               threshold;      // NAN if none
+    };
+
+    // Never modified once published
+    struct headroom_table_t {
+        std::shared_ptr<const thermal_config_t> config;
+        int64_t             timestamp;      // of the sample
+        int                 nb_sensor;
+        sensor_headroom_t   sensor[kMaxSensors];
+    };
+
+    // Only accessed by the monitor thread, indexed by configured sensor
+    std::shared_ptr<const thermal_config_t> config_;
+    int64_t timestamp_[kMaxSensors];    // of last valid sample, 0 if none
+    float value_[kMaxSensors];
+    float slope_[kMaxSensors];
+
+    std::shared_ptr<const headroom_table_t> table_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_HEADROOM_H__
@@ -21,13 +21,26 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
 
 #include <android-base/logging.h>
 #include <android-base/properties.h>
 #include <android-base/stringprintf.h>
+#include <android-base/unique_fd.h>
+#include <utils/SystemClock.h>
 
+#include "thermal-cache.h"
+#include "thermal-filter.h"
 #include "thermal-helper.h"
+#include "thermal-source.h"
+#include "thermal-telemetry.h"
 
 namespace android {
 namespace hardware {
@@ -39,74 +52,16 @@ using ::android::hardware::thermal::V2_0::TemperatureType;
 using ::android::hardware::thermal::V2_0::ThrottlingSeverity;
 using ::android::hardware::thermal::V2_0::TemperatureThreshold;
 
-// If true, stub values returned if not available on kernel side (only for managed types)
-constexpr const bool kThermalZoneStub = true;
-constexpr const bool kCoolingDeviceStub = true;
-
-static thermal_zone_t gThermalZone;
-static cooling_device_t gCoolingDevice;
-
-/* ---------------------------------------------------------- */
-/* Managed temperature types = CPU0, CPU1, GPU, BATTERY, SKIN */
-/* ---------------------------------------------------------- */
-
-// Temperature names
-constexpr const char *kTemperatureName[kTemperatureNum] = 
-    {"CPU0", "CPU1", "GPU", "BATTERY", "SKIN"};
-
-// Temperature type associated with temperature names
-constexpr const TemperatureType kTemperatureType[kTemperatureNum] = 
-    {TemperatureType::CPU, TemperatureType::CPU, TemperatureType::GPU,
-        TemperatureType::BATTERY, TemperatureType::SKIN};
-
-// Kernel thermal zone type associated with temperature names (none = no driver)
-constexpr const char *kThermalZoneType[kTemperatureNum] = 
-    {"cpu0-thermal", "cpu1-thermal", "cpu0-thermal", "dummy-battery", "none"};
-
-// Temperature threshold associated with temperature names
-static int gThermalThresholdSize = 0;
-static std::vector<TemperatureThreshold> gThermalThreshold = {
-    {
-        .type = TemperatureType::UNKNOWN,
-        .name = "none",
-        .hotThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .coldThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .vrThrottlingThreshold = NAN,
-    },
-    {
-        .type = TemperatureType::UNKNOWN,
-        .name = "none",
-        .hotThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .coldThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .vrThrottlingThreshold = NAN,
-    },
-    {
-        .type = TemperatureType::UNKNOWN,
-        .name = "none",
-        .hotThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .coldThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .vrThrottlingThreshold = NAN,
-    },
-    {
-        .type = TemperatureType::UNKNOWN,
-        .name = "none",
-        .hotThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .coldThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .vrThrottlingThreshold = NAN,
-    },
-    {
-        .type = TemperatureType::UNKNOWN,
-        .name = "none",
-        .hotThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .coldThrottlingThresholds = {{NAN, NAN, NAN, NAN, NAN, NAN, NAN}},
-        .vrThrottlingThreshold = NAN,
-    }
-};
+// If true, stub values returned if not available on kernel side (only for managed types),
+// stub code being removed otherwise (fixed by board profile)
+constexpr const bool kThermalZoneStub = BoardProfile::kThermalZoneStub;
+constexpr const bool kCoolingDeviceStub = BoardProfile::kCoolingDeviceStub;
 
-/* ThrottlingSeverity: NONE, LIGHT, MODERATE, SEVERE, CRITICAL, EMERGENCY, SHUTDOWN */
-constexpr const int kSeverityNum = static_cast<int>(ThrottlingSeverity::SHUTDOWN) + 1;
-constexpr const char *kSeverityThreshold[kSeverityNum] = 
-    {"none", "active0", "active1", "passive", "critical", "emergency", "shutdown"};
+// Trip temperature files kept open to detect trip changes, and last values read
+// (only accessed by the monitor thread, which runs discovery, values being
+// written under gSnapshotMutex for recording)
+static android::base::unique_fd gTripFd[kMaxThermalZones][kMaxThermalTrip];
+static int gTripRaw[kMaxThermalZones][kMaxThermalTrip];
 
 /* Case V1_0::IThermal */
 
@@ -137,10 +92,6 @@ static const TemperatureThreshold kTempThresholdStub = {
         .vrThrottlingThreshold = NAN,
 };
 
-/* --------------------------------------- */
-/* Managed cooling device types = FAN, CPU */
-/* --------------------------------------- */
-
 /* Case V1_0::CoolingDevice */
 
 // Cooling names
@@ -161,18 +112,6 @@ static const CoolingDevice_1_0 kCoolingStub_1_0 = {
 
 /* Case V2_0::CoolingDevice */
 
-// Cooling names
-constexpr const char *kCoolingName_2_0[kCoolingNum_2_0] = 
-    {"FAN", "CPU"};
-
-// Cooling type associated with cooling names
-constexpr const CoolingType_2_0 kCoolingType_2_0[kCoolingNum_2_0] =
-    {CoolingType_2_0::FAN, CoolingType_2_0::CPU};
-
-// Kernel cooling device type associated with cooling names (none = no driver)
-constexpr const char *kCoolingDeviceType_2_0[kCoolingNum_2_0] = 
-    {"none", "thermal-cpufreq-0"};
-
 // Stub values (case kCoolingDeviceStub enabled and no cooling device)
 static const CoolingDevice_2_0 kCoolingStub_2_0 = {
         .type = CoolingType_2_0::FAN,
@@ -180,588 +119,1380 @@ static const CoolingDevice_2_0 kCoolingStub_2_0 = {
         .value = 100,
 };
 
+static std::shared_ptr<const threshold_table_t> buildThresholdTable(const thermal_topology_t &topology,
+                                                                    const thermal_config_t &config);
+
+// Board configuration the topology has been built with, default one until discovery succeeds
+static std::shared_ptr<const thermal_config_t> gConfig = getDefaultConfig();
+
+// Topology found on platform, empty until discovery succeeds
+static std::shared_ptr<const thermal_topology_t> gTopology =
+    std::make_shared<thermal_topology_t>();
+
+// Temperature thresholds associated with sensors, replaced as a whole on trip change
+// (stub thresholds until discovery succeeds)
+static std::shared_ptr<const threshold_table_t> gThresholdTable =
+    buildThresholdTable(*gTopology, *gConfig);
+
+// Last snapshot, and lock serializing sampling with topology publication
+static std::mutex gSnapshotMutex;
+static std::shared_ptr<const thermal_snapshot_t> gSnapshot;
+static std::function<void(const thermal_snapshot_t &)> gSampleListener;
+
+// Filter state of configured sensors, only used by sampling
+static std::shared_ptr<const thermal_config_t> gFilterConfig;
+static filter_state_t gFilterState[kMaxSensors];
+
+// Source of sample reads (live sysfs, or replayed trace), and recording wrapping it, if any
+static std::shared_ptr<ThermalSource> gSource = std::make_shared<SysfsSource>();
+static std::shared_ptr<RecordingSource> gRecording;
+
+// Read errors since service start, only used by sampling
+static uint64_t gTemperatureErrors = 0;
+static uint64_t gCoolingErrors = 0;
+
 // Generic helper methods
 
 /**
- * Reads device temperature.
+ * Reads device trip raw value from its already opened file.
  *
- * @param thermal_zone_num Instance of the thermal zone
- * @param mult Multiplier used to translate temperature to Celsius
- * @param out Pointer to temperature read
+ * @param fd File descriptor of the trip temperature file
+ * @param out Pointer to raw trip value read (kernel unit)
  *
  * @return 0 on success or negative value -errno on error.
  */
-static ssize_t readTemperature(int thermal_zone_num, float mult, float *out) {
-    FILE *file;
-    char file_name[PATH_MAX];
-    float temp;
-
-    sprintf(file_name, kThermalZoneTempFileFormat, thermal_zone_num);
-    file = fopen(file_name, "r");
-    if (file == NULL) {
-        PLOG(ERROR) << "readTemperature: failed to open file (" << file_name << ")";
-        return -errno;
-    }
-    if (1 != fscanf(file, "%f", &temp)) {
-        fclose(file);
-        PLOG(ERROR) << "readTemperature: failed to read a float";
-        return errno ? -errno : -EIO;
+static ssize_t readTripRaw(int fd, int *out) {
+    char buf[16];
+    char *end;
+    ssize_t len;
+
+    // sysfs attribute content is regenerated on each read at offset 0
+    len = TEMP_FAILURE_RETRY(pread(fd, buf, sizeof(buf) - 1, 0));
+    if (len <= 0) {
+        PLOG(ERROR) << "readTripRaw: failed to read trip value";
+        return len ? -errno : -EIO;
     }
+    buf[len] = '\0';
 
-    fclose(file);
+    long value = strtol(buf, &end, 10);
+    if (end == buf) {
+        LOG(ERROR) << "readTripRaw: failed to read an integer";
+        return -EIO;
+    }
 
-    *out = temp * mult;
+    *out = static_cast<int>(value);
 
     return 0;
 }
 
+static bool scanThermalZone(thermal_zone_t *thermal_zone);
+static bool scanCoolingDevice(cooling_device_t *cooling_device);
+static bool matchTopology(const thermal_topology_t &topology);
+static void initSensor(thermal_topology_t *topology, const thermal_config_t &config);
+static bool initTemperatureThreshold(const thermal_topology_t &topology, const thermal_config_t &config,
+                                     const thermal_topology_t *previous);
+
 /**
- * Reads device trip information.
+ * Publish a new topology, with the configuration it was built with and its thresholds
  *
- * @param thermal_zone_num Instance of the thermal zone
- * @param trip_num Instance of the trip value
- * @param mult Multiplier used to translate temperature to Celsius
- * @param out Pointer to temperature read
+ * Readers never lock: they either hold the previous set, released once the
+ * last snapshot referencing it is dropped, or load the new one in full
+ * (snapshots load the set under gSnapshotMutex).
  *
- * @return 0 on success or negative value -errno on error.
+ * @param topology Topology to be published
+ * @param config Board configuration to be published
  */
-static ssize_t readTrip(int thermal_zone_num, int trip_num, float mult, float *out) {
-    FILE *file;
-    char file_name[PATH_MAX];
-    float temp;
-
-    sprintf(file_name, kTripTempFileFormat, thermal_zone_num, trip_num);
-    file = fopen(file_name, "r");
-    if (file == NULL) {
-        PLOG(ERROR) << "readTrip: failed to open file (" << file_name << ")";
-        return -errno;
+static void publishTopology(const std::shared_ptr<const thermal_topology_t> &topology,
+                            const std::shared_ptr<const thermal_config_t> &config) {
+    std::shared_ptr<const threshold_table_t> table = buildThresholdTable(*topology, *config);
+
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+    // A trace holds a single topology
+    if (gRecording != nullptr) {
+        LOG(WARNING) << "publishTopology: topology changed, recording stopped after "
+                     << gRecording->getRecordCount() << " reads";
+        gSource = gRecording->getSource();
+        gRecording.reset();
     }
-    if (1 != fscanf(file, "%f", &temp)) {
-        fclose(file);
-        PLOG(ERROR) << "readTrip: failed to read a float";
-        return errno ? -errno : -EIO;
-    }
-    fclose(file);
+    std::atomic_store(&gThresholdTable, table);
+    std::atomic_store(&gConfig, config);
+    std::atomic_store(&gTopology, topology);
+    // Next client samples the new topology
+    std::atomic_store(&gSnapshot, std::shared_ptr<const thermal_snapshot_t>());
+}
 
-    *out = temp * mult;
+/**
+ * Discover topology by a full scan of sysfs
+ *
+ * @param topology Pointer to topology found
+ * @param config Board configuration describing sensors and cooling devices
+ *
+ * @return true on success or false on error.
+ */
+static bool discoverTopology(thermal_topology_t *topology, const thermal_config_t &config) {
+    memset(topology, 0, sizeof(thermal_topology_t));
 
-    return 0;
+    // Scan thermal zone sysfs directories
+    if (!scanThermalZone(&topology->zone))
+        return false;
+
+    // Scan cooling device sysfs directories
+    if (!scanCoolingDevice(&topology->cooling))
+        return false;
+
+    // Associate thermal zones with configured sensors
+    initSensor(topology, config);
+    return true;
 }
 
 /**
- * Reads cooling device state.
+ * Initialization constants based on platform
  *
- * @param cooling_num Instance of the cooling device
- * @param out Pointer to cooling device state read
+ * Topology and thresholds are published only once all steps succeeded,
+ * clients being served stub data meanwhile. Must be called from the
+ * monitor thread.
  *
- * @return 0 on success or negative value -errno on error.
+ * @param config Board configuration describing sensors and cooling devices
+ *
+ * @return true on success or false on error.
  */
-static ssize_t readCoolingDeviceState(int cooling_num, float *out) {
-    FILE *file;
-    char file_name[PATH_MAX];
-    float state;
+bool initThermal(const std::shared_ptr<const thermal_config_t> &config) {
+    std::shared_ptr<thermal_topology_t> topology = std::make_shared<thermal_topology_t>();
+    uint32_t config_checksum = getConfigChecksum(*config);
+    int trip_raw[kMaxThermalZones][kMaxThermalTrip];
+    std::shared_ptr<ThermalSource> source;
+    bool cached;
+    bool res;
 
-    sprintf(file_name, kCoolingDeviceCurStateFileFormat, cooling_num);
-    file = fopen(file_name, "r");
-    if (file == NULL) {
-        PLOG(ERROR) << "readTemperature: failed to open file (" << file_name << ")";
-        return -errno;
+    {
+        std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+        source = gSource;
     }
-    if (1 != fscanf(file, "%f", &state)) {
-        fclose(file);
-        PLOG(ERROR) << "readTemperature: failed to read a float";
-        return errno ? -errno : -EIO;
+    // Reads replayed or simulated are done on the topology and trips of the source
+    if (source->getTopology(topology.get(), trip_raw)) {
+        initSensor(topology.get(), *config);
+        std::unique_lock<std::mutex> _lock(gSnapshotMutex);
+        for (int i=0; i < kMaxThermalZones; i++) {
+            for (int j=0; j < kMaxThermalTrip; j++) {
+                gTripFd[i][j].reset();
+                gTripRaw[i][j] = trip_raw[i][j];
+            }
+        }
+        _lock.unlock();
+        LOG(INFO) << "initThermal: " << topology->zone.nb_zone << " thermal zones, "
+                  << topology->cooling.nb_cooling << " cooling devices (from source)";
+        publishTopology(topology, config);
+        return true;
     }
 
-    fclose(file);
+    // Topology of previous boot is reused as long as the platform and configuration look the same
+    cached = loadDiscoveryCache(topology.get(), config_checksum) && matchTopology(*topology);
+    if (!cached) {
+        res = discoverTopology(topology.get(), *config);
+        if (!res)
+            return false;
+    }
+
+    // Initialize temperature thresholds with values read from kernel drivers
+    res = initTemperatureThreshold(*topology, *config, nullptr);
+    if (!res && cached) {
+        // Cache would be rejected the same way on each retry
+        LOG(WARNING) << "initThermal: cached topology does not match platform, full discovery";
+        removeDiscoveryCache();
+        cached = false;
+        res = discoverTopology(topology.get(), *config) && initTemperatureThreshold(*topology, *config, nullptr);
+    }
+    if (!res)
+        return false;
 
-    *out = state;
+    if (!cached) {
+        saveDiscoveryCache(*topology, config_checksum);
+    }
+    LOG(INFO) << "initThermal: " << topology->zone.nb_zone << " thermal zones, "
+              << topology->cooling.nb_cooling << " cooling devices"
+              << (cached ? " (cached)" : "");
 
-    return 0;
+    publishTopology(topology, config);
+    return true;
 }
 
-static bool scanThermalZone();
-static bool initTemperatureThreshold();
-static bool scanCoolingDevice();
-
 /**
- * Initialization constants based on platform
+ * Rescan platform after a thermal zone or a cooling device was added or removed
  *
- * @return true on success or false on error.
+ * Only trips of new thermal zones are opened and read. Must be called from
+ * the monitor thread, after initThermal() succeeded.
+ *
+ * @return true if a new topology has been published, false otherwise.
  */
-bool initThermal() {
-    bool res;
+bool rescanThermal() {
+    std::shared_ptr<const thermal_config_t> config = std::atomic_load(&gConfig);
+    std::shared_ptr<const thermal_topology_t> current = std::atomic_load(&gTopology);
+    std::shared_ptr<thermal_topology_t> topology = std::make_shared<thermal_topology_t>();
 
-    // Scan thermal zone sysfs directories
-    res = scanThermalZone();
-    if (!res)
+    if (!scanThermalZone(&topology->zone) || !scanCoolingDevice(&topology->cooling)) {
+        LOG(WARNING) << "rescanThermal: scan failed, keep current topology";
         return false;
+    }
 
-    // Scan cooling device sysfs directories
-    res = scanCoolingDevice();
-    if (!res)
+    // Structures are zero filled before scan: unchanged platform gives identical bytes
+    if (memcmp(&topology->zone, &current->zone, sizeof(thermal_zone_t)) == 0 &&
+        memcmp(&topology->cooling, &current->cooling, sizeof(cooling_device_t)) == 0) {
         return false;
+    }
 
-    // Initialize temperature thresholds with values read from kernel drivers
-    res = initTemperatureThreshold();
-    if (!res)
+    initSensor(topology.get(), *config);
+    if (!initTemperatureThreshold(*topology, *config, current.get())) {
+        LOG(WARNING) << "rescanThermal: failed to read trips, keep current topology";
         return false;
+    }
 
+    LOG(INFO) << "rescanThermal: " << topology->zone.nb_zone << " thermal zones, "
+              << topology->cooling.nb_cooling << " cooling devices";
+    publishTopology(topology, config);
+    saveDiscoveryCache(*topology, getConfigChecksum(*config));
     return true;
 }
 
+/**
+ * Apply a new board configuration to the current platform
+ *
+ * Thermal zones and cooling devices are not rescanned, their trip files
+ * being kept open. Must be called from the monitor thread, after
+ * initThermal() succeeded.
+ *
+ * @param config Board configuration, already validated
+ *
+ * @return true if a new topology has been published, false otherwise.
+ */
+bool reloadThermal(const std::shared_ptr<const thermal_config_t> &config) {
+    std::shared_ptr<const thermal_topology_t> current = std::atomic_load(&gTopology);
+    std::shared_ptr<thermal_topology_t> topology = std::make_shared<thermal_topology_t>();
+
+    memset(topology.get(), 0, sizeof(thermal_topology_t));
+    topology->zone = current->zone;
+    topology->cooling = current->cooling;
+
+    initSensor(topology.get(), *config);
+    if (!initTemperatureThreshold(*topology, *config, current.get())) {
+        LOG(WARNING) << "reloadThermal: failed to read trips, keep current configuration";
+        return false;
+    }
+
+    LOG(INFO) << "reloadThermal: " << topology->sensor.nb_sensor << " sensors";
+    publishTopology(topology, config);
+    saveDiscoveryCache(*topology, getConfigChecksum(*config));
+    return true;
+}
+
+/**
+ * Get back board configuration of the published topology
+ *
+ * @return configuration, never modified once returned
+ */
+std::shared_ptr<const thermal_config_t> getThermalConfig() {
+    return std::atomic_load(&gConfig);
+}
+
+/**
+ * List instances of a thermal class, sorted by sysfs index
+ *
+ * @param prefix Name prefix of instances (thermal_zone or cooling_device)
+ * @param id Pointer to sysfs indexes found
+ * @param max Maximum number of instances returned
+ *
+ * @return number of instances returned or negative value -errno on error.
+ */
+static int listThermalClass(const char *prefix, int *id, int max) {
+    size_t len = strlen(prefix);
+    std::vector<int> found;
+    struct dirent *entry;
+    DIR *dir;
+
+    dir = opendir(kThermalClassDir);
+    if (dir == NULL) {
+        PLOG(ERROR) << "listThermalClass: failed to open directory (" << kThermalClassDir << ")";
+        return -errno;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        char *end;
+        if (strncmp(entry->d_name, prefix, len) != 0 || !isdigit(entry->d_name[len])) {
+            continue;
+        }
+        long value = strtol(entry->d_name + len, &end, 10);
+        if (*end == '\0') {
+            found.push_back(static_cast<int>(value));
+        }
+    }
+    closedir(dir);
+
+    std::sort(found.begin(), found.end());
+    if (found.size() > max) {
+        LOG(WARNING) << "listThermalClass: " << found.size() << " " << prefix
+                     << " found, only " << max << " managed";
+        found.resize(max);
+    }
+    std::copy(found.begin(), found.end(), id);
+
+    return found.size();
+}
+
 /**
  * Scan sysfs thermal zone directories
  *
+ * @param thermal_zone Pointer to thermal zones found
+ *
  * @return true on success or false on error.
  */
-static bool scanThermalZone() {
+static bool scanThermalZone(thermal_zone_t *thermal_zone) {
     FILE *file;
     char name[PATH_MAX];
     char type[32];
     struct stat st;
+    int num;
+
+    num = listThermalClass("thermal_zone", thermal_zone->zone_id, kMaxThermalZones);
+    if (num < 0)
+        return false;
 
-    for (int i=0;i<kMaxThermalZones;i++) {
-        sprintf(name, kThermalZoneTypeFileFormat, i);
-        if (!stat(name, &st)) {
-            // read thermal zone type
+    for (int i=0;i<num;i++) {
+        int id = thermal_zone->zone_id[i];
+        sprintf(name, kThermalZoneTypeFileFormat, id);
+        // read thermal zone type
+        file = fopen(name, "r");
+        if (file != NULL) {
+            if (1 == fscanf(file, "%31s", type)) {
+                strcpy(thermal_zone->zone_type[i], type);
+            }
+            fclose(file);
+        } else {
+            // error during scan operation
+            return false;
+        }
+        thermal_zone->trip[i].nb_trip = 0;
+        for (int j=0;j<kMaxThermalTrip;j++) {
+            sprintf(name, kTripTypeFileFormat, id, j);
+            if (stat(name, &st)) {
+                break;
+            }
+            // read thermal zone trip type
             file = fopen(name, "r");
             if (file != NULL) {
-                if (1 == fscanf(file, "%s", type)) {
-                    strcpy(gThermalZone.zone_type[i], type);
+                if (1 == fscanf(file, "%31s", type)) {
+                    strcpy(thermal_zone->trip[i].trip_type[j], type);
                 }
                 fclose(file);
             } else {
                 // error during scan operation
                 return false;
             }
-            for (int j=0;j<kMaxThermalTrip;j++) {
-                sprintf(name, kTripTypeFileFormat, i, j);
-                if (!stat(name, &st)) {
-                    // read thermal zone trip type
-                    file = fopen(name, "r");
-                    if (file != NULL) {
-                        if (1 == fscanf(file, "%s", type)) {
-                            strcpy(gThermalZone.trip[i].trip_type[j], type);
-                        }
-                        fclose(file);
-                    } else {
-                        // error during scan operation
-                        return false;
-                    }
-                } else {
-                    gThermalZone.trip[i].nb_trip = j;
-                    break;
-                }
-            }
-        } else {
-            gThermalZone.nb_zone = i;
-            break;
+            thermal_zone->trip[i].nb_trip = j + 1;
         }
     }
+    thermal_zone->nb_zone = num;
     return true;
 }
 
 /**
  * Scan sysfs cooling device directories
  *
+ * @param cooling_device Pointer to cooling devices found
+ *
  * @return true on success or false on error.
  */
-static bool scanCoolingDevice() {
+static bool scanCoolingDevice(cooling_device_t *cooling_device) {
     FILE *file;
     char name[PATH_MAX];
     char type[32];
-    struct stat st;
+    int num;
 
-    for (int i=0;i<kMaxCoolingDevices;i++) {
-        sprintf(name, kCoolingDeviceTypeFileFormat, i);
-        if (!stat(name, &st)) {
-            // read thermal zone type
-            file = fopen(name, "r");
-            if (file != NULL) {
-                if (1 == fscanf(file, "%s", type)) {
-                    strcpy(gCoolingDevice.cooling_type[i], type);
-                }
-                fclose(file);
-            } else {
-                // error during scan operation
-                return false;
+    num = listThermalClass("cooling_device", cooling_device->cooling_id, kMaxCoolingDevices);
+    if (num < 0)
+        return false;
+
+    for (int i=0;i<num;i++) {
+        sprintf(name, kCoolingDeviceTypeFileFormat, cooling_device->cooling_id[i]);
+        // read cooling device type
+        file = fopen(name, "r");
+        if (file != NULL) {
+            if (1 == fscanf(file, "%31s", type)) {
+                strcpy(cooling_device->cooling_type[i], type);
             }
+            fclose(file);
         } else {
-            gCoolingDevice.nb_cooling = i;
-            break;
+            // error during scan operation
+            return false;
+        }
+        // read cooling device max state, fixed by driver
+        cooling_device->max_state[i] = -1;
+        sprintf(name, kCoolingDeviceMaxStateFileFormat, cooling_device->cooling_id[i]);
+        file = fopen(name, "r");
+        if (file != NULL) {
+            if (1 != fscanf(file, "%d", &cooling_device->max_state[i])) {
+                cooling_device->max_state[i] = -1;
+            }
+            fclose(file);
         }
     }
+    cooling_device->nb_cooling = num;
     return true;
 }
 
 /**
- * Get back Severity associated to kernel trip type
+ * Read type of a thermal zone or a cooling device
  *
- * @return index
+ * @param file_name Path of the type file
+ * @param type Pointer to type read (32 bytes)
+ *
+ * @return true on success or false on error.
  */
-static int getSeverityIndex(char* trip_type) {
-    for (int i=0; i < kSeverityNum; i++) {
-        if (strcmp(kSeverityThreshold[i], trip_type) == 0 ) {
-            return i;
-        }
+static bool readType(const char *file_name, char *type) {
+    FILE *file;
+    bool res;
+
+    file = fopen(file_name, "r");
+    if (file == NULL) {
+        return false;
     }
-    return -1;
+    res = (1 == fscanf(file, "%31s", type));
+    fclose(file);
+
+    return res;
 }
 
 /**
- * Initialize temperature thresholds based on read kernel trip values
+ * Check a topology still matches the platform, based on the indexes of
+ * thermal zones and cooling devices and on the types of thermal zones
  *
- * @return true on success or false on error.
+ * @param topology Topology to be checked
+ *
+ * @return true if topology matches or false otherwise.
  */
-static bool initTemperatureThreshold() {
-    int num = 0;
-    float value;
+static bool matchTopology(const thermal_topology_t &topology) {
+    int zone_id[kMaxThermalZones];
+    int cooling_id[kMaxCoolingDevices];
+    char name[PATH_MAX];
+    char type[32];
 
-    for (int i=0; i < gThermalZone.nb_zone; i++) {
-        for (int k=0; k < kTemperatureNum; k++) {
-            if (strcmp(gThermalZone.zone_type[i], kThermalZoneType[k]) == 0) {
-                gThermalThreshold[num].type = kTemperatureType[k];
-                gThermalThreshold[num].name = kTemperatureName[k];
-                for (int j=0; j < gThermalZone.trip[i].nb_trip; j++) {
-                    if (0 == readTrip(i, j, 0.0001, &value)) {
-                        int index = getSeverityIndex(gThermalZone.trip[i].trip_type[j]);
-                        if (index < 0) {
-                            LOG(WARNING) << "initTemperatureThreshold: unknown trip type " << gThermalZone.trip[i].trip_type[j];
-                        } else {
-                            gThermalThreshold[num].hotThrottlingThresholds[index] = value;
-                        }
-                    } else {
-                        return false;
-                    }
-                }
-                num++;
+    if (listThermalClass("thermal_zone", zone_id, kMaxThermalZones) != topology.zone.nb_zone ||
+        listThermalClass("cooling_device", cooling_id, kMaxCoolingDevices) != topology.cooling.nb_cooling) {
+        return false;
+    }
+    for (int i=0; i < topology.cooling.nb_cooling; i++) {
+        if (cooling_id[i] != topology.cooling.cooling_id[i]) {
+            return false;
+        }
+    }
+    for (int i=0; i < topology.zone.nb_zone; i++) {
+        if (zone_id[i] != topology.zone.zone_id[i]) {
+            return false;
+        }
+        sprintf(name, kThermalZoneTypeFileFormat, zone_id[i]);
+        if (!readType(name, type) || strcmp(type, topology.zone.zone_type[i]) != 0) {
+            return false;
+        }
+        // Trips added, removed or re-typed
+        const thermal_trip_t &trip = topology.zone.trip[i];
+        for (int j=0; j < trip.nb_trip; j++) {
+            sprintf(name, kTripTypeFileFormat, zone_id[i], j);
+            if (!readType(name, type) || strcmp(type, trip.trip_type[j]) != 0) {
+                return false;
             }
         }
+        sprintf(name, kTripTypeFileFormat, zone_id[i], trip.nb_trip);
+        if (trip.nb_trip < kMaxThermalTrip && access(name, F_OK) == 0) {
+            return false;
+        }
     }
 
-    gThermalThresholdSize = num;
     return true;
 }
 
-// Helper methods for ::android::hardware::thermal::V2_0::IThermal follow.
+/**
+ * Get back Severity associated to kernel trip type
+ *
+ * @return index or -1 if trip type is not configured
+ */
+static int getSeverityIndex(const thermal_config_t &config, const char* trip_type) {
+    for (int i=0; i < config.nb_trip; i++) {
+        if (strcmp(config.trip[i].trip_type, trip_type) == 0 ) {
+            return static_cast<int>(config.trip[i].severity);
+        }
+    }
+    return -1;
+}
 
 /**
- * Fill temperature for all available sensors
- * 
- * @param temperatures Pointer to temperatures data
+ * Get back index associated to temperature type in threshold table
  *
- * @return number of data returned
+ * @return index or -1 if type is out of range
  */
-ssize_t fillTemperatures_2_0(std::vector<Temperature_2_0> *temperatures) {
-    ssize_t num = 0;
-    float value;
+static int getTypeIndex(TemperatureType type) {
+    int index = static_cast<int>(type) + 1;
 
-    if (temperatures == NULL || temperatures->size() < kTemperatureNum) {
-        LOG(ERROR) << "fillTemperatures_2_0: incorrect buffer";
-        return 0;
-    }
+    if (index < 0 || index >= kTemperatureTypeNum)
+        return -1;
+    return index;
+}
 
-    if (gThermalZone.nb_zone == 0) {
-        if (kThermalZoneStub) {
-            temperatures->clear();
-            temperatures->insert(temperatures->begin(), kTempStub_2_0);
-            return 1;
+/**
+ * Build temperature thresholds table based on last kernel trip values read,
+ * thresholds set by configuration taking precedence
+ *
+ * @param topology Topology the thresholds are built for
+ * @param config Board configuration of the topology
+ *
+ * @return new table, to be published
+ */
+static std::shared_ptr<const threshold_table_t> buildThresholdTable(const thermal_topology_t &topology,
+                                                                    const thermal_config_t &config) {
+    std::shared_ptr<threshold_table_t> table = std::make_shared<threshold_table_t>();
+    std::vector<TemperatureThreshold> type_thresholds[kTemperatureTypeNum];
+
+    const thermal_zone_t &thermal_zone = topology.zone;
+    const thermal_sensor_t &sensor = topology.sensor;
+
+    if (thermal_zone.nb_zone == 0) {
+        if constexpr (kThermalZoneStub) {
+            table->all.resize(1);
+            table->all[0] = kTempThresholdStub;
+            table->type[getTypeIndex(kTempThresholdStub.type)] = table->all;
         }
-        LOG(WARNING) << "fillTemperatures_2_0: nb_zone 0 while kThermalZoneStub is false";
-        return 0;
+        return table;
     }
 
+    table->all.resize(sensor.nb_sensor);
+    for (int s=0; s < sensor.nb_sensor; s++) {
+        int zone = sensor.zone[s];
+        const sensor_config_t &sensor_config = config.sensor[sensor.name[s]];
+        TemperatureThreshold &threshold = table->all[s];
+
+        threshold.type = sensor_config.type;
+        threshold.name = sensor_config.name;
+        for (int i=0; i < kSeverityNum; i++) {
+            threshold.hotThrottlingThresholds[i] = NAN;
+            threshold.coldThrottlingThresholds[i] = NAN;
+        }
+        threshold.vrThrottlingThreshold = NAN;
 
-    for (int i=0; i < gThermalZone.nb_zone; i++) {
-        if (0 == readTemperature(i, 0.0001, &value)) {
-            for (int j=0; j < kTemperatureNum; j++) {
-                if (strcmp(gThermalZone.zone_type[i], kThermalZoneType[j]) == 0) {
-                    (*temperatures)[num].type = kTemperatureType[j];
-                    (*temperatures)[num].name = kTemperatureName[j];
-                    (*temperatures)[num].value = value;
-                    // TODO: add management of throttling status
-                    (*temperatures)[num].throttlingStatus = ThrottlingSeverity::NONE;
-                    num++;
-                }
+        // Virtual sensors have no kernel trips
+        for (int j=0; zone >= 0 && j < thermal_zone.trip[zone].nb_trip; j++) {
+            int index = getSeverityIndex(config, thermal_zone.trip[zone].trip_type[j]);
+            if (index >= 0) {
+                threshold.hotThrottlingThresholds[index] = gTripRaw[zone][j] * config.temperature_mult;
+            }
+        }
+        for (int i=0; i < kSeverityNum; i++) {
+            if (!std::isnan(sensor_config.hot_threshold[i])) {
+                threshold.hotThrottlingThresholds[i] = sensor_config.hot_threshold[i];
             }
         }
+
+        int index = getTypeIndex(threshold.type);
+        if (index >= 0) {
+            type_thresholds[index].push_back(threshold);
+        }
     }
 
-    return num;
+    for (int i=0; i < kTemperatureTypeNum; i++) {
+        table->type[i] = type_thresholds[i];
+    }
+
+    return table;
 }
 
 /**
- * Fill temperature for all sensors associated to expected temperature type
- * 
- * @param temperatures Pointer to temperature data
- * @param type type of temperature required
+ * Initialize sensors, associating thermal zones with configured sensors
  *
- * @return number of data returned
+ * Virtual sensors follow physical ones, and are kept only if all their
+ * inputs have been found.
+ *
+ * @param topology Pointer to topology, whose sensors are filled
+ * @param config Board configuration describing sensors
  */
-ssize_t fillTemperature_2_0(std::vector<Temperature_2_0> *temperatures, TemperatureType type) {
-    ssize_t num = 0;
-    float value;
+static void initSensor(thermal_topology_t *topology, const thermal_config_t &config) {
+    const thermal_zone_t &thermal_zone = topology->zone;
+    thermal_sensor_t &sensor = topology->sensor;
+    bool found[kMaxSensors] = {};
+    int num = 0;
 
-    if (temperatures == NULL || temperatures->size() < kTemperatureNum) {
-        LOG(ERROR) << "fillTemperature_2_0: incorrect buffer";
-        return 0;
-    }
-
-    if (gThermalZone.nb_zone == 0) {
-        if ((kThermalZoneStub) && (type == kTempStub_2_0.type)) {
-            temperatures->clear();
-            temperatures->insert(temperatures->begin(), kTempStub_2_0);
-            return 1;
-        }
-        LOG(WARNING) << "fillTemperature_2_0: nb_zone 0 while kThermalZoneStub is false";
-        return 0;
-    }
-
-    for (int i=0; i < gThermalZone.nb_zone; i++) {
-        if (0 == readTemperature(i, 0.0001, &value)) {
-            for (int j=0; j < kTemperatureNum; j++) {
-                if (strcmp(gThermalZone.zone_type[i], kThermalZoneType[j]) == 0) {
-                    if (type == kTemperatureType[j]) {
-                        (*temperatures)[num].type = kTemperatureType[j];
-                        (*temperatures)[num].name = kTemperatureName[j];
-                        (*temperatures)[num].value = value;
-                        // TODO: add management of throttling status
-                        (*temperatures)[num].throttlingStatus = ThrottlingSeverity::NONE;
-                        num++;
-                    }
+    for (int i=0; i < thermal_zone.nb_zone; i++) {
+        for (int k=0; k < config.nb_sensor; k++) {
+            if (!config.sensor[k].is_virtual &&
+                strcmp(thermal_zone.zone_type[i], config.sensor[k].zone_type) == 0) {
+                if (num == kMaxSensors) {
+                    LOG(WARNING) << "initSensor: too many sensors, ignore " << config.sensor[k].name;
+                    continue;
                 }
+                sensor.zone[num] = i;
+                sensor.name[num] = k;
+                found[k] = true;
+                num++;
             }
         }
     }
 
-    return num;
+    for (int k=0; k < config.nb_sensor; k++) {
+        const virtual_sensor_t &virtual_sensor = config.sensor[k].virtual_sensor;
+        bool complete = config.sensor[k].is_virtual && num < kMaxSensors;
+        for (int i=0; complete && i < virtual_sensor.nb_input; i++) {
+            complete = found[virtual_sensor.input[i]];
+        }
+        if (complete) {
+            sensor.zone[num] = -1;
+            sensor.name[num] = k;
+            num++;
+        }
+    }
+    sensor.nb_sensor = num;
 }
 
 /**
- * Fill temperature thresholds associated to all available sensors
- * 
- * @param temperature_thresholds Pointer to temperature thresholds data
+ * Check whether a thermal zone has the same trips in two topologies
  *
- * @return number of data returned
+ * @return true if thermal zone slot i of topology and slot k of previous match
  */
-ssize_t fillTemperaturesThreshold(std::vector<TemperatureThreshold> *temperature_thresholds) {
+static bool sameZone(const thermal_topology_t &topology, int i, const thermal_topology_t &previous, int k) {
+    return topology.zone.zone_id[i] == previous.zone.zone_id[k] &&
+           strcmp(topology.zone.zone_type[i], previous.zone.zone_type[k]) == 0 &&
+           memcmp(&topology.zone.trip[i], &previous.zone.trip[k], sizeof(thermal_trip_t)) == 0;
+}
+
+/**
+ * Read kernel trip values used for temperature thresholds
+ *
+ * Trip files of thermal zones already present in previous topology are
+ * kept open, with their last values.
+ *
+ * @param topology Topology whose trips are read
+ * @param config Board configuration mapping trip types to severities
+ * @param previous Topology currently published, or nullptr
+ *
+ * @return true on success or false on error (trips of previous topology unchanged).
+ */
+static bool initTemperatureThreshold(const thermal_topology_t &topology, const thermal_config_t &config,
+                                     const thermal_topology_t *previous) {
+    const thermal_zone_t &thermal_zone = topology.zone;
+    android::base::unique_fd trip_fd[kMaxThermalZones][kMaxThermalTrip];
+    int trip_raw[kMaxThermalZones][kMaxThermalTrip] = {};
+    int kept[kMaxThermalZones];
+    char name[PATH_MAX];
+
+    // Open trips of new thermal zones only: nothing is changed on error
+    for (int i=0; i < thermal_zone.nb_zone; i++) {
+        kept[i] = -1;
+        for (int k=0; previous != nullptr && k < previous->zone.nb_zone; k++) {
+            if (sameZone(topology, i, *previous, k)) {
+                kept[i] = k;
+                break;
+            }
+        }
+        if (kept[i] >= 0) {
+            continue;
+        }
 
-    if (gThermalZone.nb_zone == 0) {
-        if (kThermalZoneStub) {
-            temperature_thresholds->clear();
-            temperature_thresholds->insert(temperature_thresholds->begin(), kTempThresholdStub);
-            return 1;
+        for (int j=0; j < thermal_zone.trip[i].nb_trip; j++) {
+            if (getSeverityIndex(config, thermal_zone.trip[i].trip_type[j]) < 0) {
+                LOG(WARNING) << "initTemperatureThreshold: unknown trip type " << thermal_zone.trip[i].trip_type[j];
+            }
+            sprintf(name, kTripTempFileFormat, thermal_zone.zone_id[i], j);
+            trip_fd[i][j].reset(TEMP_FAILURE_RETRY(open(name, O_RDONLY | O_CLOEXEC)));
+            if (trip_fd[i][j] < 0) {
+                PLOG(ERROR) << "initTemperatureThreshold: failed to open file (" << name << ")";
+                return false;
+            }
+            if (0 != readTripRaw(trip_fd[i][j], &trip_raw[i][j])) {
+                return false;
+            }
         }
-        return 0;
     }
 
-    temperature_thresholds = &gThermalThreshold;
+    for (int i=0; i < thermal_zone.nb_zone; i++) {
+        for (int j=0; kept[i] >= 0 && j < thermal_zone.trip[i].nb_trip; j++) {
+            trip_fd[i][j] = std::move(gTripFd[kept[i]][j]);
+            trip_raw[i][j] = gTripRaw[kept[i]][j];
+        }
+    }
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+    for (int i=0; i < kMaxThermalZones; i++) {
+        for (int j=0; j < kMaxThermalTrip; j++) {
+            gTripFd[i][j] = std::move(trip_fd[i][j]);
+            gTripRaw[i][j] = trip_raw[i][j];
+        }
+    }
 
-    return gThermalThresholdSize;
+    return true;
 }
 
 /**
- * Fill temperature thresholds associated to sensors of the exepected type
- * 
- * @param temperature_thresholds Pointer to temperature thresholds data
+ * Get back current temperature thresholds table
+ *
+ * @return table, never modified once returned
+ */
+std::shared_ptr<const threshold_table_t> getThresholdTable() {
+    return std::atomic_load(&gThresholdTable);
+}
+
+/**
+ * Get back temperature thresholds of sensors of the expected type
+ *
+ * @param table Temperature thresholds table
+ * @param type Type of temperature required
+ *
+ * @return thresholds, empty if no sensor of this type
+ */
+const hidl_vec<TemperatureThreshold> &getTypeThreshold(const threshold_table_t &table, TemperatureType type) {
+    static const hidl_vec<TemperatureThreshold> kNoThreshold;
+    int index = getTypeIndex(type);
+
+    if (index < 0)
+        return kNoThreshold;
+    return table.type[index];
+}
+
+/**
+ * Fill temperature thresholds a snapshot was sampled with
+ *
+ * @param snapshot Snapshot of sensors
+ * @param filter_type If true, only thresholds of the expected type are returned
+ * @param type Type of temperature required
+ * @param thresholds Pointer to threshold data
  *
  * @return number of data returned
  */
-ssize_t fillTemperatureThreshold(std::vector<TemperatureThreshold> *temperature_thresholds, TemperatureType type) {
-    int index = 0;
+ssize_t fillTemperatureThresholds(const thermal_snapshot_t &snapshot, bool filter_type, TemperatureType type,
+                                  hidl_vec<TemperatureThreshold> *thresholds) {
+    *thresholds = filter_type ? getTypeThreshold(*snapshot.thresholds, type) : snapshot.thresholds->all;
+    return thresholds->size();
+}
+
+/**
+ * Check kernel trip values and rebuild temperature thresholds table if one changed
+ *
+ * @return true if table has been rebuilt, false otherwise.
+ */
+bool updateTemperatureThreshold() {
+    std::shared_ptr<const thermal_config_t> config = std::atomic_load(&gConfig);
+    std::shared_ptr<const thermal_topology_t> topology = std::atomic_load(&gTopology);
+    const thermal_zone_t &thermal_zone = topology->zone;
+    bool changed = false;
+    int value;
+
+    for (int i=0; i < thermal_zone.nb_zone; i++) {
+        for (int j=0; j < thermal_zone.trip[i].nb_trip; j++) {
+            if (gTripFd[i][j] < 0 || 0 != readTripRaw(gTripFd[i][j], &value)) {
+                continue;
+            }
+            if (value != gTripRaw[i][j]) {
+                LOG(INFO) << "updateTemperatureThreshold: " << thermal_zone.zone_type[i]
+                          << " trip " << j << " changed from " << gTripRaw[i][j] << " to " << value;
+                std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+                gTripRaw[i][j] = value;
+                changed = true;
+            }
+        }
+    }
 
-    temperature_thresholds->clear();
+    if (changed) {
+        std::atomic_store(&gThresholdTable, buildThresholdTable(*topology, *config));
+    }
+    return changed;
+}
 
-    if (gThermalZone.nb_zone == 0) {
-        if ((kThermalZoneStub) && (type == kTempThresholdStub.type)) {
-            temperature_thresholds->insert(temperature_thresholds->begin(), kTempThresholdStub);
-            return 1;
+// Sampling engine: a single pass on sensors and cooling devices feeds all interface versions
+
+/**
+ * Get back throttling severity of a temperature based on its hot thresholds
+ *
+ * @param threshold Temperature thresholds of the sensor
+ * @param value Temperature read
+ *
+ * @return severity
+ */
+static ThrottlingSeverity getSeverity(const TemperatureThreshold &threshold, float value) {
+    for (int i = kSeverityNum - 1; i > 0; i--) {
+        if (!std::isnan(threshold.hotThrottlingThresholds[i]) &&
+            value >= threshold.hotThrottlingThresholds[i]) {
+            return static_cast<ThrottlingSeverity>(i);
         }
-        return 0;
     }
+    return ThrottlingSeverity::NONE;
+}
+
+/**
+ * Get back throttling severity of a temperature, with hysteresis on falling
+ *
+ * A severity is entered when temperature reaches its hot threshold, and left
+ * when temperature goes below its hot threshold minus hysteresis.
+ *
+ * @param threshold Temperature thresholds of the sensor
+ * @param value Temperature read
+ * @param previous Severity of previous read
+ * @param hysteresis Hysteresis, in Celsius
+ *
+ * @return severity
+ */
+ThrottlingSeverity getSeverity(const TemperatureThreshold &threshold, float value, ThrottlingSeverity previous,
+                               float hysteresis) {
+    ThrottlingSeverity severity = getSeverity(threshold, value);
+
+    if (severity >= previous) {
+        return severity;
+    }
+    return std::max(severity, std::min(previous, getSeverity(threshold, value + hysteresis)));
+}
 
-    for (int i=0; i < gThermalThresholdSize; i++) {
-        if (gThermalThreshold[i].type == type) {
-            temperature_thresholds->insert(temperature_thresholds->begin() + index, gThermalThreshold[i]);
-            index++;
+/**
+ * Compute a virtual sensor from the values of its physical inputs
+ *
+ * @param virtual_sensor Virtual sensor description
+ * @param value Values of configured sensors
+ * @param valid Validity of values of configured sensors
+ * @param out Pointer to value computed
+ *
+ * @return true on success or false if an input is not available.
+ */
+static bool computeVirtualSensor(const virtual_sensor_t &virtual_sensor, const float *value,
+                                 const bool *valid, float *out) {
+    float result = 0;
+
+    for (int i=0; i < virtual_sensor.nb_input; i++) {
+        int input = virtual_sensor.input[i];
+        if (!valid[input]) {
+            return false;
+        }
+        switch (virtual_sensor.combination) {
+            case VirtualCombination::WEIGHTED_SUM:
+                result += virtual_sensor.weight[i] * value[input];
+                break;
+            case VirtualCombination::MAX:
+                result = (i == 0) ? value[input] : std::max(result, value[input]);
+                break;
+            case VirtualCombination::MIN:
+                result = (i == 0) ? value[input] : std::min(result, value[input]);
+                break;
         }
     }
+    *out = result + virtual_sensor.offset;
 
-    return index;
+    return true;
 }
 
 /**
- * Fill states for all available cooling devices
- * 
- * @param cooling_device Pointer to cooling device data
+ * Read all sensors and cooling devices once, gSnapshotMutex being held
  *
- * @return number of data returned
+ * @return new snapshot, published for all clients
  */
-ssize_t fillCoolingDevices_2_0(std::vector<CoolingDevice_2_0> *cooling_device) {
-    ssize_t num = 0;
+static std::shared_ptr<const thermal_snapshot_t> sampleThermalLocked() {
+    std::shared_ptr<thermal_snapshot_t> snapshot = std::make_shared<thermal_snapshot_t>();
+    float zone_value[kMaxThermalZones];
+    ssize_t zone_status[kMaxThermalZones];
+    bool zone_read[kMaxThermalZones] = {};
+    float sensor_value[kMaxSensors];
+    bool sensor_valid[kMaxSensors] = {};
     float value;
 
-    if (cooling_device == NULL) {
-        LOG(ERROR) << "fillCoolingDevices_2_0: incorrect buffer";
-        return 0;
-    }
+    snapshot->timestamp = gSource->getTimestamp();
+    snapshot->config = std::atomic_load(&gConfig);
+    snapshot->topology = std::atomic_load(&gTopology);
+    snapshot->thresholds = getThresholdTable();
 
-    if (gCoolingDevice.nb_cooling == 0) {
-        if (kCoolingDeviceStub) {
-            cooling_device->clear();
-            cooling_device->insert(cooling_device->begin(), kCoolingStub_2_0);
-            return 1;
+    const thermal_config_t &config = *snapshot->config;
+    const thermal_topology_t &topology = *snapshot->topology;
+
+    // Filter states are indexed by configured sensor, and restart with a new configuration
+    if (gFilterConfig != snapshot->config) {
+        gFilterConfig = snapshot->config;
+        for (int k=0; k < kMaxSensors; k++) {
+            resetFilter(&gFilterState[k]);
         }
-        return 0;
     }
 
-    for (int i=0; i < gCoolingDevice.nb_cooling; i++) {
-        if (0 == readCoolingDeviceState(i, &value)) {
-            for (int j=0; j < kCoolingNum_2_0; j++) {
-                if (strcmp(gCoolingDevice.cooling_type[i], kCoolingDeviceType_2_0[j]) == 0) {
-                    (*cooling_device)[num].type = kCoolingType_2_0[j];
-                    (*cooling_device)[num].name = kCoolingName_2_0[j];
-                    (*cooling_device)[num].value = value;
-                    num++;
+    snapshot->stub_temperature = (topology.zone.nb_zone == 0) && kThermalZoneStub;
+    snapshot->stub_cooling = (topology.cooling.nb_cooling == 0) && kCoolingDeviceStub;
+
+    // A thermal zone shared by several sensors is read only once, virtual
+    // sensors being computed from physical sensors sampled just before
+    for (int s=0; s < topology.sensor.nb_sensor; s++) {
+        int zone = topology.sensor.zone[s];
+        int name = topology.sensor.name[s];
+        if (zone < 0) {
+            if (!computeVirtualSensor(config.sensor[name].virtual_sensor, sensor_value, sensor_valid, &value)) {
+                continue;
+            }
+        } else {
+            if (!zone_read[zone]) {
+                zone_status[zone] = gSource->readZoneTemp(topology.zone.zone_id[zone], &zone_value[zone]);
+                if (zone_status[zone] == 0) {
+                    zone_value[zone] *= config.temperature_mult;
                 }
+                zone_read[zone] = true;
+                gTemperatureErrors += (zone_status[zone] != 0);
+            }
+            if (zone_status[zone] != 0) {
+                continue;
             }
+            value = zone_value[zone];
+        }
+        // Severities, subscriptions and virtual sensors only see filtered values
+        sensor_value[name] = applyFilter(config.sensor[name].filter, &gFilterState[name], value);
+        sensor_valid[name] = true;
+
+        temperature_sample_t &sample = snapshot->temperature[snapshot->nb_temperature++];
+        sample.sensor = s;
+        sample.name = name;
+        sample.raw_value = value;
+        sample.value = sensor_value[name];
+        sample.severity = ThrottlingSeverity::NONE;
+        if (s < snapshot->thresholds->all.size()) {
+            sample.severity = getSeverity(snapshot->thresholds->all[s], sample.value);
         }
     }
 
-    return num;
+    for (int i=0; i < topology.cooling.nb_cooling; i++) {
+        if (0 == gSource->readCoolingState(topology.cooling.cooling_id[i], &value)) {
+            cooling_sample_t &sample = snapshot->cooling[snapshot->nb_cooling++];
+            sample.cooling = i;
+            sample.value = value;
+        } else {
+            gCoolingErrors++;
+        }
+    }
+    snapshot->nb_temperature_error = gTemperatureErrors;
+    snapshot->nb_cooling_error = gCoolingErrors;
+
+    // Listener (emergency path) sees the sample before any client
+    if (gSampleListener) {
+        gSampleListener(*snapshot);
+    }
+    publishTelemetry(*snapshot);
+    std::atomic_store(&gSnapshot, std::shared_ptr<const thermal_snapshot_t>(snapshot));
+    return snapshot;
 }
 
 /**
- * Fill states for all cooling devices associated to the expected type
- * 
- * @param cooling_device Pointer to cooling device data
- * @param type Cooling device type expected
+ * Read all sensors and cooling devices, whatever the age of the last snapshot
  *
- * @return number of data returned
+ * @return new snapshot
  */
-ssize_t fillCoolingDevice_2_0(std::vector<CoolingDevice_2_0> *cooling_device, CoolingType_2_0 type) {
-    ssize_t num = 0;
-    float value;
+std::shared_ptr<const thermal_snapshot_t> sampleThermal() {
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+
+    return sampleThermalLocked();
+}
+
+/**
+ * Set source of sample reads, before initThermal()
+ *
+ * @param source Source, live sysfs by default
+ */
+void setThermalSource(const std::shared_ptr<ThermalSource> &source) {
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+
+    gSource = source;
+    gRecording.reset();
+}
+
+/**
+ * Start recording all sample reads to a trace, after initThermal() succeeded
+ *
+ * @param path Path of the trace, replaced if it exists
+ *
+ * @return true on success or false on error or if recording already.
+ */
+bool startThermalRecord(const std::string &path) {
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+    trace_header_t header = {};
 
-    if (cooling_device == NULL || cooling_device->size() < kCoolingNum_2_0) {
-        LOG(ERROR) << "fillCoolingDevices_2_0: incorrect buffer";
-        return 0;
+    if (gRecording != nullptr) {
+        return false;
     }
 
-    if (gCoolingDevice.nb_cooling == 0) {
-        if ((kCoolingDeviceStub) && (type == kCoolingStub_2_0.type)) {
-            cooling_device->clear();
-            cooling_device->insert(cooling_device->begin(), kCoolingStub_2_0);
-            return 1;
+    android::base::unique_fd fd(TEMP_FAILURE_RETRY(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640)));
+    if (fd < 0) {
+        PLOG(ERROR) << "startThermalRecord: failed to open file (" << path << ")";
+        return false;
+    }
+
+    header.magic = kTraceMagic;
+    header.version = kTraceVersion;
+    header.config_checksum = getConfigChecksum(*std::atomic_load(&gConfig));
+    header.topology_size = sizeof(thermal_topology_t);
+    header.topology = *std::atomic_load(&gTopology);
+    for (int i=0; i < kMaxThermalZones; i++) {
+        for (int j=0; j < kMaxThermalTrip; j++) {
+            header.trip_raw[i][j] = gTripRaw[i][j];
         }
-        return 0;
+    }
+    if (TEMP_FAILURE_RETRY(write(fd, &header, sizeof(header))) != sizeof(header)) {
+        PLOG(ERROR) << "startThermalRecord: failed to write file (" << path << ")";
+        return false;
     }
 
-    for (int i=0; i < gCoolingDevice.nb_cooling; i++) {
-        if (0 == readCoolingDeviceState(i, &value)) {
-            for (int j=0; j < kCoolingNum_2_0; j++) {
-                if (type == kCoolingType_2_0[j]) {
-                    (*cooling_device)[num].type = kCoolingType_2_0[j];
-                    (*cooling_device)[num].name = kCoolingName_2_0[j];
-                    (*cooling_device)[num].value = value;
-                    num++;
-                }
+    gRecording = std::make_shared<RecordingSource>(gSource, std::move(fd));
+    gSource = gRecording;
+    LOG(INFO) << "startThermalRecord: recording to " << path;
+    return true;
+}
+
+/**
+ * Stop recording sample reads, trace being flushed
+ *
+ * @return number of reads recorded, or -1 if not recording.
+ */
+ssize_t stopThermalRecord() {
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+
+    if (gRecording == nullptr) {
+        return -1;
+    }
+    ssize_t count = gRecording->getRecordCount();
+    gSource = gRecording->getSource();
+    gRecording.reset();
+    LOG(INFO) << "stopThermalRecord: " << count << " reads recorded";
+    return count;
+}
+
+/**
+ * Set function called on each new sample, gSnapshotMutex being held
+ *
+ * @param listener Function, which must not block
+ */
+void setSampleListener(std::function<void(const thermal_snapshot_t &)> listener) {
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+
+    gSampleListener = listener;
+}
+
+/**
+ * Get back last published snapshot, whatever its age, without sampling
+ *
+ * @return last snapshot, or nullptr before the first sample
+ */
+std::shared_ptr<const thermal_snapshot_t> getLastSnapshot() {
+    return std::atomic_load(&gSnapshot);
+}
+
+/**
+ * Get back a snapshot not older than the sampling period
+ *
+ * @return last snapshot, or a new one if it is too old
+ */
+std::shared_ptr<const thermal_snapshot_t> getSnapshot() {
+    std::shared_ptr<const thermal_snapshot_t> snapshot = std::atomic_load(&gSnapshot);
+
+    if (snapshot != nullptr &&
+        elapsedRealtimeNano() - snapshot->timestamp < snapshot->config->polling_period_ns) {
+        return snapshot;
+    }
+
+    std::lock_guard<std::mutex> _lock(gSnapshotMutex);
+    // Another client may have sampled while waiting for the lock
+    snapshot = std::atomic_load(&gSnapshot);
+    if (snapshot != nullptr &&
+        elapsedRealtimeNano() - snapshot->timestamp < snapshot->config->polling_period_ns) {
+        return snapshot;
+    }
+    return sampleThermalLocked();
+}
+
+// Projections of a snapshot to ::android::hardware::thermal V1_0 and V2_0 types follow.
+
+template <typename F, int... I>
+static inline void unrollIndex(int num, F &f, std::integer_sequence<int, I...>) {
+    ((I < num ? f(I) : void()), ...);
+}
+
+/**
+ * Call f(i) for each i in [0, num), num being at most N
+ *
+ * Loop is unrolled at compile time on board profiles with a fixed number of
+ * sensors, and kept as is on generic builds.
+ */
+template <int N, typename F>
+static inline void forEachIndex(int num, F &&f) {
+    if constexpr (BoardProfile::kUnrolled) {
+        unrollIndex(num, f, std::make_integer_sequence<int, N>());
+    } else {
+        for (int i=0; i < num; i++) {
+            f(i);
+        }
+    }
+}
+
+template <typename T> struct TemperatureProjection;
+
+template <> struct TemperatureProjection<Temperature_1_0> {
+    static const Temperature_1_0 &stub() { return kTempStub_1_0; }
+
+    static void project(const thermal_snapshot_t &snapshot, const temperature_sample_t &sample,
+                        Temperature_1_0 *out) {
+        const sensor_config_t &sensor = snapshot.config->sensor[sample.name];
+        out->type = static_cast<::android::hardware::thermal::V1_0::TemperatureType>(sensor.type);
+        out->name = sensor.name;
+        out->currentValue = sample.value;
+        out->throttlingThreshold = NAN;
+        out->shutdownThreshold = NAN;
+        out->vrThrottlingThreshold = NAN;
+        if (sample.sensor < snapshot.thresholds->all.size()) {
+            const TemperatureThreshold &threshold = snapshot.thresholds->all[sample.sensor];
+            out->throttlingThreshold = threshold.hotThrottlingThresholds[static_cast<int>(ThrottlingSeverity::SEVERE)];
+            // Use critical temperature as shutdown threshold (current kernel configuration)
+            out->shutdownThreshold = threshold.hotThrottlingThresholds[static_cast<int>(ThrottlingSeverity::CRITICAL)];
+            out->vrThrottlingThreshold = threshold.vrThrottlingThreshold;
+        }
+    }
+};
+
+template <> struct TemperatureProjection<Temperature_2_0> {
+    static const Temperature_2_0 &stub() { return kTempStub_2_0; }
+
+    static void project(const thermal_snapshot_t &snapshot, const temperature_sample_t &sample,
+                        Temperature_2_0 *out) {
+        const sensor_config_t &sensor = snapshot.config->sensor[sample.name];
+        out->type = sensor.type;
+        out->name = sensor.name;
+        out->value = sample.value;
+        out->throttlingStatus = sample.severity;
+    }
+};
+
+template <> struct TemperatureProjection<RawTemperature> {
+    static const RawTemperature &stub() {
+        static const RawTemperature kRawStub = {kTempStub_2_0.type, kTempStub_2_0.name, kTempStub_2_0.value,
+                                                kTempStub_2_0.value};
+        return kRawStub;
+    }
+
+    static void project(const thermal_snapshot_t &snapshot, const temperature_sample_t &sample,
+                        RawTemperature *out) {
+        const sensor_config_t &sensor = snapshot.config->sensor[sample.name];
+        out->type = sensor.type;
+        out->name = sensor.name;
+        out->rawValue = sample.raw_value;
+        out->value = sample.value;
+    }
+};
+
+template <typename T> struct CoolingProjection;
+
+template <> struct CoolingProjection<CoolingDevice_1_0> {
+    // Only one cooling device is reported on V1_0
+    static constexpr int kMaxNum = 1;
+
+    static const CoolingDevice_1_0 &stub() { return kCoolingStub_1_0; }
+
+    static int match(const thermal_config_t &, const char *cooling_type) {
+        return (strcmp(cooling_type, kCoolingDeviceType_1_0) == 0) ? 0 : -1;
+    }
+
+    static CoolingType_2_0 type(const thermal_config_t &, int) {
+        return static_cast<CoolingType_2_0>(kCoolingType_1_0);
+    }
+
+    static void project(const thermal_config_t &, int, float value, CoolingDevice_1_0 *out) {
+        out->type = kCoolingType_1_0;
+        out->name = kCoolingName_1_0;
+        out->currentValue = value;
+    }
+};
+
+template <> struct CoolingProjection<CoolingDevice_2_0> {
+    static constexpr int kMaxNum = kMaxCoolingDevices;
+
+    static const CoolingDevice_2_0 &stub() { return kCoolingStub_2_0; }
+
+    static int match(const thermal_config_t &config, const char *cooling_type) {
+        for (int j=0; j < config.nb_cooling; j++) {
+            if (strcmp(cooling_type, config.cooling[j].cooling_type) == 0) {
+                return j;
             }
         }
+        return -1;
     }
 
-    return num;
-}
+    static CoolingType_2_0 type(const thermal_config_t &config, int name) {
+        return config.cooling[name].type;
+    }
 
-// Helper methods for ::android::hardware::thermal::V1_0::IThermal follow.
+    static void project(const thermal_config_t &config, int name, float value, CoolingDevice_2_0 *out) {
+        out->type = config.cooling[name].type;
+        out->name = config.cooling[name].name;
+        out->value = value;
+    }
+};
 
 /**
- * Fill temperature for all available sensors
- * 
+ * Fill temperature of sensors from a snapshot
+ *
+ * @param snapshot Snapshot of sensors
+ * @param filter_type If true, only sensors of the expected type are returned
+ * @param type Type of temperature required
  * @param temperatures Pointer to temperature data
  *
  * @return number of data returned
  */
-ssize_t fillTemperatures_1_0(std::vector<Temperature_1_0> *temperatures) {
+template <typename T>
+ssize_t fillTemperatures(const thermal_snapshot_t &snapshot, bool filter_type, TemperatureType type,
+                         hidl_vec<T> *temperatures) {
     ssize_t num = 0;
-    float value;
 
-    if (temperatures == NULL || temperatures->size() < kTemperatureNum) {
-        LOG(ERROR) << "fillTemperatures_1_0: incorrect buffer";
-        return 0;
-    }
-
-    if (gThermalZone.nb_zone == 0) {
-        if (kThermalZoneStub) {
-            temperatures->clear();
-            temperatures->insert(temperatures->begin(), kTempStub_1_0);
-            return 1;
-        }
-        LOG(WARNING) << "fillTemperatures_1_0: nb_zone 0 while kThermalZoneStub is false";
-        return 0;
-    }
-
-    for (int i=0; i < gThermalZone.nb_zone; i++) {
-        if (0 == readTemperature(i, 0.0001, &value)) {
-            for (int j=0; j < kTemperatureNum; j++) {
-                if (strcmp(gThermalZone.zone_type[i], kThermalZoneType[j]) == 0) {
-                    (*temperatures)[num].type = static_cast<::android::hardware::thermal::V1_0::TemperatureType>(kTemperatureType[j]);
-                    (*temperatures)[num].name = kTemperatureName[j];
-                    (*temperatures)[num].currentValue = value;
-                    (*temperatures)[num].throttlingThreshold = gThermalThreshold[j].hotThrottlingThresholds[static_cast<int>(ThrottlingSeverity::SEVERE)];
-                    // Use critical temperature as shutdown threshold (current kernel configuration)
-                    (*temperatures)[num].shutdownThreshold = gThermalThreshold[j].hotThrottlingThresholds[static_cast<int>(ThrottlingSeverity::CRITICAL)];
-                    (*temperatures)[num].vrThrottlingThreshold = gThermalThreshold[j].vrThrottlingThreshold;
-                    num++;
-                }
+    if constexpr (kThermalZoneStub) {
+        if (snapshot.stub_temperature) {
+            if (!filter_type || type == kTempStub_2_0.type) {
+                temperatures->resize(1);
+                (*temperatures)[0] = TemperatureProjection<T>::stub();
+                return 1;
             }
+            temperatures->resize(0);
+            return 0;
         }
     }
 
+    temperatures->resize(snapshot.nb_temperature);
+    forEachIndex<kMaxSensors>(snapshot.nb_temperature, [&](int i) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        if (filter_type && snapshot.config->sensor[sample.name].type != type) {
+            return;
+        }
+        TemperatureProjection<T>::project(snapshot, sample, &(*temperatures)[num]);
+        num++;
+    });
+    temperatures->resize(num);
+
     return num;
 }
 
+template ssize_t fillTemperatures(const thermal_snapshot_t &, bool, TemperatureType,
+                                  hidl_vec<Temperature_1_0> *);
+template ssize_t fillTemperatures(const thermal_snapshot_t &, bool, TemperatureType,
+                                  hidl_vec<Temperature_2_0> *);
+template ssize_t fillTemperatures(const thermal_snapshot_t &, bool, TemperatureType,
+                                  hidl_vec<RawTemperature> *);
+
 /**
- * Fill state for all available cooling devices
- * 
+ * Fill state of cooling devices from a snapshot
+ *
+ * @param snapshot Snapshot of cooling devices
+ * @param filter_type If true, only cooling devices of the expected type are returned
+ * @param type Cooling device type expected
  * @param cooling_device Pointer to cooling device data
  *
  * @return number of data returned
  */
-ssize_t fillCoolingDevices_1_0(std::vector<CoolingDevice_1_0> *cooling_device) {
+template <typename T>
+ssize_t fillCoolingDevices(const thermal_snapshot_t &snapshot, bool filter_type, CoolingType_2_0 type,
+                           hidl_vec<T> *cooling_device) {
     ssize_t num = 0;
-    float value;
 
-    if (cooling_device == NULL) {
-        LOG(ERROR) << "fillCoolingDevice_1_0: incorrect buffer";
-        return 0;
+    if constexpr (kCoolingDeviceStub) {
+        if (snapshot.stub_cooling) {
+            if (!filter_type || type == static_cast<CoolingType_2_0>(CoolingProjection<T>::stub().type)) {
+                cooling_device->resize(1);
+                (*cooling_device)[0] = CoolingProjection<T>::stub();
+                return 1;
+            }
+            cooling_device->resize(0);
+            return 0;
+        }
     }
 
-    if (gCoolingDevice.nb_cooling == 0) {
-        if (kCoolingDeviceStub) {
-            cooling_device->clear();
-            cooling_device->insert(cooling_device->begin(), kCoolingStub_1_0);
-            return 1;
+    cooling_device->resize(snapshot.nb_cooling);
+    forEachIndex<kMaxCoolingDevices>(snapshot.nb_cooling, [&](int i) {
+        const cooling_sample_t &sample = snapshot.cooling[i];
+        const thermal_config_t &config = *snapshot.config;
+        if (num >= CoolingProjection<T>::kMaxNum) {
+            return;
+        }
+        int name = CoolingProjection<T>::match(config, snapshot.topology->cooling.cooling_type[sample.cooling]);
+        if (name < 0 || (filter_type && CoolingProjection<T>::type(config, name) != type)) {
+            return;
+        }
+        CoolingProjection<T>::project(config, name, sample.value, &(*cooling_device)[num]);
+        num++;
+    });
+    cooling_device->resize(num);
+
+    return num;
+}
+
+template ssize_t fillCoolingDevices(const thermal_snapshot_t &, bool, CoolingType_2_0,
+                                    hidl_vec<CoolingDevice_1_0> *);
+template ssize_t fillCoolingDevices(const thermal_snapshot_t &, bool, CoolingType_2_0,
+                                    hidl_vec<CoolingDevice_2_0> *);
+
+/**
+ * Find a configured sensor by name
+ *
+ * @return index in configured sensors or -1 if not found
+ */
+static int findConfigSensor(const thermal_config_t &config, const char *name) {
+    for (int k=0; k < config.nb_sensor; k++) {
+        if (strcmp(config.sensor[k].name, name) == 0) {
+            return k;
         }
-        return 0;
     }
+    return -1;
+}
 
-    for (int i=0; i < gCoolingDevice.nb_cooling; i++) {
-        if (0 == readCoolingDeviceState(i, &value)) {
-            if (strcmp(gCoolingDevice.cooling_type[i], kCoolingDeviceType_1_0) == 0) {
-                (*cooling_device)[num].type = kCoolingType_1_0;
-                (*cooling_device)[num].name = kCoolingName_1_0;
-                (*cooling_device)[num].currentValue = value;
-                num++;
-                break;
-            }
+/**
+ * Fill temperature of sensors whose severity changed between two snapshots
+ *
+ * @param previous Snapshot previously notified
+ * @param current Last snapshot
+ * @param temperatures Pointer to temperature data
+ *
+ * @return number of data returned
+ */
+ssize_t fillThrottlingChanges(const thermal_snapshot_t &previous, const thermal_snapshot_t &current,
+                              hidl_vec<Temperature_2_0> *temperatures) {
+    ThrottlingSeverity severity[kMaxSensors];
+
+    // Samples are matched by sensor name: sensor indexes change on rescan,
+    // and name indexes when configuration changes
+    for (int k=0; k < kMaxSensors; k++) {
+        severity[k] = ThrottlingSeverity::NONE;
+    }
+    for (int i=0; i < previous.nb_temperature; i++) {
+        int name = previous.temperature[i].name;
+        if (previous.config != current.config) {
+            name = findConfigSensor(*current.config, previous.config->sensor[name].name);
+        }
+        if (name >= 0) {
+            severity[name] = previous.temperature[i].severity;
         }
     }
 
+    return fillThrottlingChanges(severity, current, temperatures);
+}
+
+/**
+ * Fill temperature of sensors whose severity changed since last notified
+ *
+ * @param notified Severity last notified, per configured sensor of current snapshot
+ * @param current Last snapshot
+ * @param temperatures Pointer to temperature data
+ *
+ * @return number of data returned
+ */
+ssize_t fillThrottlingChanges(const ThrottlingSeverity (&notified)[kMaxSensors], const thermal_snapshot_t &current,
+                              hidl_vec<Temperature_2_0> *temperatures) {
+    ssize_t num = 0;
+
+    temperatures->resize(current.nb_temperature);
+    forEachIndex<kMaxSensors>(current.nb_temperature, [&](int i) {
+        const temperature_sample_t &sample = current.temperature[i];
+        if (sample.severity != notified[sample.name]) {
+            TemperatureProjection<Temperature_2_0>::project(current, sample, &(*temperatures)[num]);
+            num++;
+        }
+    });
+    temperatures->resize(num);
+
     return num;
 }
 
+// Helper methods for ::android::hardware::thermal::V1_0::IThermal follow.
+
 /**
  * Fill CPU usage
  * 
@@ -840,12 +1571,12 @@ ssize_t fillCpuUsages(std::vector<CpuUsage> *cpuUsages) {
             fclose(cpu_file);
         }
 
-        (*cpuUsages)[size].name = kTemperatureName[size];
+        (*cpuUsages)[size].name = android::base::StringPrintf("CPU%zu", size);
         (*cpuUsages)[size].active = active;
         (*cpuUsages)[size].total = total;
         (*cpuUsages)[size].isOnline = static_cast<bool>(online);
 
-        LOG(DEBUG) << "fillCpuUsages: "<< kTemperatureName[size] << ": "
+        LOG(DEBUG) << "fillCpuUsages: CPU" << size << ": "
                    << active << " " << total << " " <<  online;
         size++;
     }
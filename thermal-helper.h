@@ -30,7 +30,14 @@
 #ifndef __THERMAL_HELPER_H__
 #define __THERMAL_HELPER_H__
 
+#include <functional>
+#include <memory>
+#include <string>
+
 #include <android/hardware/thermal/2.0/IThermal.h>
+#include <vendor/stm32mpu/hardware/thermal/1.0/types.h>
+
+#include "thermal-config.h"
 
 namespace android {
 namespace hardware {
@@ -38,6 +45,7 @@ namespace thermal {
 namespace V2_0 {
 namespace implementation {
 
+using ::android::hardware::hidl_vec;
 using ::android::hardware::thermal::V1_0::CpuUsage;
 using CoolingDevice_1_0 = ::android::hardware::thermal::V1_0::CoolingDevice;
 using CoolingType_1_0 = ::android::hardware::thermal::V1_0::CoolingType;
@@ -46,20 +54,21 @@ using Temperature_1_0 = ::android::hardware::thermal::V1_0::Temperature;
 using CoolingDevice_2_0 = ::android::hardware::thermal::V2_0::CoolingDevice;
 using CoolingType_2_0 = ::android::hardware::thermal::V2_0::CoolingType;
 using Temperature_2_0 = ::android::hardware::thermal::V2_0::Temperature;
+using ::android::hardware::thermal::V2_0::TemperatureThreshold;
+using ::android::hardware::thermal::V2_0::TemperatureType;
+using ::android::hardware::thermal::V2_0::ThrottlingSeverity;
+using ::vendor::stm32mpu::hardware::thermal::V1_0::RawTemperature;
 
-
-
-// Maximum number of sensors treated
-constexpr unsigned int kCpuNum = 2;
-constexpr unsigned int kTemperatureNum = 3 + kCpuNum;
-
-// Maximum number of cooling devices treated
-constexpr unsigned int kCoolingNum_2_0 = 2;
+// Number of CPUs whose usage is reported
+constexpr unsigned int kCpuNum = BoardProfile::kCpuNum;
 
 // Path to get back CPU usage data
 constexpr const char *kCpuUsageFile = "/proc/stat";
 constexpr const char *kCpuOnlineFileFormat = "/sys/devices/system/cpu/cpu%d/online";
 
+// Path of thermal class, holding thermal zones and cooling devices
+constexpr const char *kThermalClassDir = "/sys/class/thermal";
+
 // Path to get back thermal zone data
 constexpr const char *kThermalZoneTypeFileFormat = "/sys/class/thermal/thermal_zone%d/type";
 constexpr const char *kThermalZoneTempFileFormat = "/sys/class/thermal/thermal_zone%d/temp";
@@ -84,6 +93,7 @@ struct thermal_trip_t {
 
 struct thermal_zone_t {
     int             nb_zone;
+    int             zone_id[kMaxThermalZones];      // sysfs index
     char            zone_type[kMaxThermalZones][32];
     thermal_trip_t  trip[kMaxThermalZones];
 };
@@ -93,22 +103,105 @@ constexpr unsigned int kMaxCoolingDevices = 3;
 
 struct cooling_device_t {
     int             nb_cooling;
+    int             cooling_id[kMaxCoolingDevices]; // sysfs index
     char            cooling_type[kMaxCoolingDevices][32];
+    int             max_state[kMaxCoolingDevices];  // -1 if unknown
 };
 
-bool initThermal();
+// Used to get information on sensors (thermal zone matching a configured sensor)
+struct thermal_sensor_t {
+    int             nb_sensor;
+    int             zone[kMaxSensors];      // index in thermal zones, -1 for virtual sensors
+    int             name[kMaxSensors];      // index in configured sensors
+};
 
-ssize_t fillTemperatures_1_0(std::vector<Temperature_1_0> *temperatures);
-ssize_t fillCoolingDevices_1_0(std::vector<CoolingDevice_1_0> *cooling);
+// Platform topology found by discovery, never modified once published
+struct thermal_topology_t {
+    thermal_zone_t      zone;
+    cooling_device_t    cooling;
+    thermal_sensor_t    sensor;
+};
 
-ssize_t fillTemperatures_2_0(std::vector<Temperature_2_0> *temperatures);
-ssize_t fillTemperature_2_0(std::vector<Temperature_2_0> *temperatures, TemperatureType type);
+// Number of temperature types (UNKNOWN to NPU)
+constexpr int kTemperatureTypeNum = static_cast<int>(TemperatureType::NPU) + 2;
 
-ssize_t fillTemperaturesThreshold(std::vector<TemperatureThreshold> *temperature_thresholds);
-ssize_t fillTemperatureThreshold(std::vector<TemperatureThreshold> *temperature_thresholds, TemperatureType type);
+// Temperature thresholds, never modified once published
+struct threshold_table_t {
+    // thresholds of all sensors, in sensor order
+    hidl_vec<TemperatureThreshold> all;
+    // thresholds of sensors of a given type, indexed by type + 1
+    hidl_vec<TemperatureThreshold> type[kTemperatureTypeNum];
+};
+
+// Used to store a sensor read
+struct temperature_sample_t {
+    int                 sensor;     // index in sensors and thresholds table
+    int                 name;       // index in configured sensors
+    float               raw_value;  // as read, or computed from filtered inputs (virtual sensor)
+    float               value;      // filtered
+    ThrottlingSeverity  severity;
+};
+
+// Used to store a cooling device read
+struct cooling_sample_t {
+    int                 cooling;    // index in scanned cooling devices
+    float               value;
+};
+
+// Result of a single pass on all sensors and cooling devices, never modified once published
+// (a snapshot younger than the configured polling period is shared by all clients)
+struct thermal_snapshot_t {
+    int64_t                 timestamp;  // elapsed realtime in ns
+    std::shared_ptr<const thermal_config_t> config;
+    std::shared_ptr<const thermal_topology_t> topology;
+    std::shared_ptr<const threshold_table_t> thresholds;
+    bool                    stub_temperature;
+    bool                    stub_cooling;
+    int                     nb_temperature;
+    temperature_sample_t    temperature[kMaxSensors];
+    int                     nb_cooling;
+    cooling_sample_t        cooling[kMaxCoolingDevices];
+    uint64_t                nb_temperature_error;   // thermal zone read errors since service start
+    uint64_t                nb_cooling_error;       // cooling device read errors since service start
+};
 
-ssize_t fillCoolingDevices_2_0(std::vector<CoolingDevice_2_0> *cooling);
-ssize_t fillCoolingDevice_2_0(std::vector<CoolingDevice_2_0> *cooling, CoolingType_2_0 type);
+bool initThermal(const std::shared_ptr<const thermal_config_t> &config);
+bool rescanThermal();
+bool reloadThermal(const std::shared_ptr<const thermal_config_t> &config);
+
+std::shared_ptr<const thermal_config_t> getThermalConfig();
+
+std::shared_ptr<const threshold_table_t> getThresholdTable();
+const hidl_vec<TemperatureThreshold> &getTypeThreshold(const threshold_table_t &table, TemperatureType type);
+ssize_t fillTemperatureThresholds(const thermal_snapshot_t &snapshot, bool filter_type, TemperatureType type,
+                                  hidl_vec<TemperatureThreshold> *thresholds);
+bool updateTemperatureThreshold();
+ThrottlingSeverity getSeverity(const TemperatureThreshold &threshold, float value, ThrottlingSeverity previous,
+                               float hysteresis);
+
+class ThermalSource;
+void setThermalSource(const std::shared_ptr<ThermalSource> &source);
+bool startThermalRecord(const std::string &path);
+ssize_t stopThermalRecord();
+
+std::shared_ptr<const thermal_snapshot_t> sampleThermal();
+void setSampleListener(std::function<void(const thermal_snapshot_t &)> listener);
+std::shared_ptr<const thermal_snapshot_t> getSnapshot();
+std::shared_ptr<const thermal_snapshot_t> getLastSnapshot();
+
+// T is Temperature_1_0, Temperature_2_0 or RawTemperature
+template <typename T>
+ssize_t fillTemperatures(const thermal_snapshot_t &snapshot, bool filter_type, TemperatureType type,
+                         hidl_vec<T> *temperatures);
+// T is CoolingDevice_1_0 or CoolingDevice_2_0
+template <typename T>
+ssize_t fillCoolingDevices(const thermal_snapshot_t &snapshot, bool filter_type, CoolingType_2_0 type,
+                           hidl_vec<T> *cooling_device);
+
+ssize_t fillThrottlingChanges(const thermal_snapshot_t &previous, const thermal_snapshot_t &current,
+                              hidl_vec<Temperature_2_0> *temperatures);
+ssize_t fillThrottlingChanges(const ThrottlingSeverity (&notified)[kMaxSensors], const thermal_snapshot_t &current,
+                              hidl_vec<Temperature_2_0> *temperatures);
 
 ssize_t fillCpuUsages(std::vector<CpuUsage> *cpuUsages);
 
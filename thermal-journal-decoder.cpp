@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host decoder of the thermal event journal pulled from a device, e.g.:
+//   adb pull /data/vendor/thermal/journal.bin && thermal-journal-decoder journal.bin
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "thermal-journal.h"
+
+using namespace ::android::hardware::thermal::V2_0::implementation;
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <journal file>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream stream(argv[1], std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (data.size() != kJournalSize) {
+        fprintf(stderr, "%s: expecting %zu bytes, got %zu\n", argv[1], kJournalSize, data.size());
+        return 1;
+    }
+
+    const journal_header_t *header = reinterpret_cast<const journal_header_t *>(data.data());
+    if (header->magic != kJournalMagic || header->version != kJournalVersion ||
+        header->record_size != sizeof(journal_record_t) || header->capacity != kJournalCapacity) {
+        fprintf(stderr, "%s: not a version %u journal\n", argv[1], kJournalVersion);
+        return 1;
+    }
+
+    printf("%u service starts, %" PRIu64 " records written\n", header->boot, header->head);
+    uint64_t first = header->head > kJournalCapacity ? header->head - kJournalCapacity : 0;
+    for (uint64_t sequence = first; sequence < header->head; sequence++) {
+        const journal_record_t *record = getJournalRecord(header, sequence);
+        if (record == nullptr) {
+            printf("#%" PRIu64 ": invalid record\n", sequence);
+            continue;
+        }
+        printf("%s\n", formatJournalRecord(*record).c_str());
+    }
+
+    return 0;
+}
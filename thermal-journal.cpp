@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <android-base/logging.h>
+#include <android-base/unique_fd.h>
+#include <utils/SystemClock.h>
+
+#include "thermal-helper.h"
+#include "thermal-journal.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::unique_fd;
+
+// Period of sensor summaries
+constexpr int64_t kJournalSummaryPeriodNs = 60000000000LL;
+
+// Records are scheduled for writeback by batch: after kJournalSyncRecords
+// records, or kJournalSyncPeriodNs after the oldest unflushed one. They are
+// written at once when a sensor reaches kJournalSyncSeverity, as shutdown may
+// follow (MS_ASYNC only marks pages dirty)
+constexpr uint32_t kJournalSyncRecords = 64;
+constexpr int64_t kJournalSyncPeriodNs = 10000000000LL;
+constexpr ThrottlingSeverity kJournalSyncSeverity = ThrottlingSeverity::CRITICAL;
+
+struct journal_summary_t {
+    uint32_t            count;
+    float               min;
+    float               max;
+    double              sum;
+    ThrottlingSeverity  severity;
+};
+
+// Journal file mapping, written by the monitor thread only, read by debug()
+static std::mutex gJournalMutex;
+static journal_header_t *gJournal = nullptr;
+static uint32_t gJournalUnsynced = 0;
+static int64_t gJournalUnsyncedSince = 0;
+
+// Severities and summaries of configured sensors, reset by a new configuration
+static std::shared_ptr<const thermal_config_t> gJournalConfig;
+static ThrottlingSeverity gJournalSeverity[kMaxSensors];
+static journal_summary_t gJournalSummary[kMaxSensors];
+static int64_t gJournalSummaryStart = 0;
+
+// States of scanned cooling devices, reset by a new topology (-1 if unknown)
+static std::shared_ptr<const thermal_topology_t> gJournalTopology;
+static int gJournalCoolingState[kMaxCoolingDevices];
+
+/**
+ * Get back configured name of a cooling device
+ *
+ * @param config Board configuration
+ * @param cooling_type Kernel cooling device type
+ *
+ * @return configured name, or kernel type if not configured.
+ */
+static const char *getCoolingName(const thermal_config_t &config, const char *cooling_type) {
+    for (int j=0; j < config.nb_cooling; j++) {
+        if (strcmp(config.cooling[j].cooling_type, cooling_type) == 0) {
+            return config.cooling[j].name;
+        }
+    }
+    return cooling_type;
+}
+
+/**
+ * Append a record to the journal, gJournalMutex being held
+ *
+ * The ring is only written through the mapping: no system call is issued.
+ *
+ * @param record Record to be appended, sequence, boot and wall clock being set here
+ */
+static void appendRecord(journal_record_t *record) {
+    journal_record_t *ring = reinterpret_cast<journal_record_t *>(gJournal + 1);
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    record->sequence = gJournal->head;
+    record->boot = gJournal->boot;
+    record->realtime_ms = ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+
+    // Record is complete before head covers it, a torn record being rejected by its sequence
+    memcpy(&ring[gJournal->head % kJournalCapacity], record, sizeof(journal_record_t));
+    gJournal->head++;
+
+    if (gJournalUnsynced++ == 0) {
+        gJournalUnsyncedSince = record->elapsed_ns;
+    }
+}
+
+/**
+ * Flush journal to storage, gJournalMutex being held
+ *
+ * @param flags MS_ASYNC or MS_SYNC
+ */
+static void flushJournal(int flags) {
+    if (msync(gJournal, kJournalSize, flags) < 0) {
+        PLOG(WARNING) << "flushJournal: failed to sync journal";
+    }
+    gJournalUnsynced = 0;
+}
+
+/**
+ * Map journal file, created or reset if not valid, and record service start
+ *
+ * @return true on success or false on error.
+ */
+bool initJournal() {
+    std::lock_guard<std::mutex> _lock(gJournalMutex);
+    struct stat st;
+
+    unique_fd fd(TEMP_FAILURE_RETRY(open(kJournalFile, O_RDWR | O_CREAT | O_CLOEXEC, 0640)));
+    if (fd < 0) {
+        PLOG(ERROR) << "initJournal: failed to open file (" << kJournalFile << ")";
+        return false;
+    }
+    if (fstat(fd, &st) < 0) {
+        PLOG(ERROR) << "initJournal: failed to stat file (" << kJournalFile << ")";
+        return false;
+    }
+    // Size is fixed: a file of another size is emptied
+    if (st.st_size != kJournalSize && (ftruncate(fd, 0) < 0 || ftruncate(fd, kJournalSize) < 0)) {
+        PLOG(ERROR) << "initJournal: failed to size file (" << kJournalFile << ")";
+        return false;
+    }
+
+    void *map = mmap(nullptr, kJournalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        PLOG(ERROR) << "initJournal: failed to map file (" << kJournalFile << ")";
+        return false;
+    }
+
+    journal_header_t *header = static_cast<journal_header_t *>(map);
+    if (header->magic != kJournalMagic || header->version != kJournalVersion ||
+        header->record_size != sizeof(journal_record_t) || header->capacity != kJournalCapacity) {
+        LOG(INFO) << "initJournal: creating journal (" << kJournalFile << ")";
+        memset(map, 0, kJournalSize);
+        header->magic = kJournalMagic;
+        header->version = kJournalVersion;
+        header->record_size = sizeof(journal_record_t);
+        header->capacity = kJournalCapacity;
+    }
+    header->boot++;
+    gJournal = header;
+
+    std::fill(gJournalCoolingState, gJournalCoolingState + kMaxCoolingDevices, -1);
+
+    journal_record_t record = {};
+    record.type = static_cast<uint16_t>(JournalRecordType::BOOT);
+    record.elapsed_ns = elapsedRealtimeNano();
+    appendRecord(&record);
+    flushJournal(MS_ASYNC);
+
+    return true;
+}
+
+/**
+ * Record changes of a periodic sample, and sensor summaries
+ *
+ * @param snapshot New sample
+ */
+void updateJournal(const thermal_snapshot_t &snapshot) {
+    std::lock_guard<std::mutex> _lock(gJournalMutex);
+    bool sync = false;
+
+    if (gJournal == nullptr) {
+        return;
+    }
+
+    if (gJournalConfig != snapshot.config) {
+        gJournalConfig = snapshot.config;
+        std::fill(gJournalSeverity, gJournalSeverity + kMaxSensors, ThrottlingSeverity::NONE);
+        std::fill(gJournalSummary, gJournalSummary + kMaxSensors, journal_summary_t{});
+        gJournalSummaryStart = snapshot.timestamp;
+    }
+    if (gJournalTopology != snapshot.topology) {
+        gJournalTopology = snapshot.topology;
+        std::fill(gJournalCoolingState, gJournalCoolingState + kMaxCoolingDevices, -1);
+    }
+
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        const char *name = gJournalConfig->sensor[sample.name].name;
+
+        if (sample.severity != gJournalSeverity[sample.name]) {
+            journal_record_t record = {};
+            record.type = static_cast<uint16_t>(JournalRecordType::SEVERITY);
+            record.elapsed_ns = snapshot.timestamp;
+            strncpy(record.name, name, sizeof(record.name));
+            record.previous = static_cast<int32_t>(gJournalSeverity[sample.name]);
+            record.current = static_cast<int32_t>(sample.severity);
+            record.value = sample.value;
+            appendRecord(&record);
+            gJournalSeverity[sample.name] = sample.severity;
+            sync |= sample.severity >= kJournalSyncSeverity;
+        }
+
+        journal_summary_t &summary = gJournalSummary[sample.name];
+        summary.min = summary.count == 0 ? sample.value : std::min(summary.min, sample.value);
+        summary.max = summary.count == 0 ? sample.value : std::max(summary.max, sample.value);
+        summary.sum += sample.value;
+        summary.severity = std::max(summary.severity, sample.severity);
+        summary.count++;
+    }
+
+    for (int j=0; j < snapshot.nb_cooling; j++) {
+        const cooling_sample_t &sample = snapshot.cooling[j];
+        int state = static_cast<int>(sample.value);
+
+        if (state != gJournalCoolingState[sample.cooling]) {
+            journal_record_t record = {};
+            record.type = static_cast<uint16_t>(JournalRecordType::COOLING);
+            record.elapsed_ns = snapshot.timestamp;
+            const char *name = getCoolingName(*gJournalConfig, snapshot.topology->cooling.cooling_type[sample.cooling]);
+            strncpy(record.name, name, sizeof(record.name));
+            record.previous = gJournalCoolingState[sample.cooling];
+            record.current = state;
+            appendRecord(&record);
+            gJournalCoolingState[sample.cooling] = state;
+        }
+    }
+
+    if (snapshot.timestamp - gJournalSummaryStart >= kJournalSummaryPeriodNs) {
+        for (int k=0; k < gJournalConfig->nb_sensor; k++) {
+            journal_summary_t &summary = gJournalSummary[k];
+            if (summary.count == 0) {
+                continue;
+            }
+            journal_record_t record = {};
+            record.type = static_cast<uint16_t>(JournalRecordType::SUMMARY);
+            record.elapsed_ns = snapshot.timestamp;
+            strncpy(record.name, gJournalConfig->sensor[k].name, sizeof(record.name));
+            record.current = static_cast<int32_t>(summary.severity);
+            record.value = summary.sum / summary.count;
+            record.min = summary.min;
+            record.max = summary.max;
+            record.count = summary.count;
+            appendRecord(&record);
+            summary = journal_summary_t{};
+        }
+        gJournalSummaryStart = snapshot.timestamp;
+    }
+
+    if (gJournalUnsynced > 0 && sync) {
+        flushJournal(MS_SYNC);
+    } else if (gJournalUnsynced >= kJournalSyncRecords ||
+               (gJournalUnsynced > 0 && snapshot.timestamp - gJournalUnsyncedSince >= kJournalSyncPeriodNs)) {
+        flushJournal(MS_ASYNC);
+    }
+}
+
+/**
+ * Flush journal to storage and wait for completion
+ */
+void syncJournal() {
+    std::lock_guard<std::mutex> _lock(gJournalMutex);
+
+    if (gJournal != nullptr) {
+        flushJournal(MS_SYNC);
+    }
+}
+
+/**
+ * Dump last records of the journal, including previous boots
+ *
+ * @param max_records Maximum number of records dumped
+ * @param out Pointer to dump, oldest record first
+ */
+void dumpJournal(size_t max_records, std::string *out) {
+    std::lock_guard<std::mutex> _lock(gJournalMutex);
+
+    if (gJournal == nullptr) {
+        return;
+    }
+    uint64_t count = std::min<uint64_t>({gJournal->head, kJournalCapacity, max_records});
+    for (uint64_t sequence = gJournal->head - count; sequence < gJournal->head; sequence++) {
+        const journal_record_t *record = getJournalRecord(gJournal, sequence);
+        if (record != nullptr) {
+            *out += "Journal " + formatJournalRecord(*record) + "\n";
+        }
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
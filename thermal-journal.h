@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_JOURNAL_H__
+#define __THERMAL_JOURNAL_H__
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Layout of the thermal event journal, kept across reboots and read by the
+// host decoder: any layout change must bump the version
+
+constexpr const char *kJournalFile = "/data/vendor/thermal/journal.bin";
+
+constexpr uint32_t kJournalMagic = 0x4c4e524a;     // "JRNL"
+constexpr uint32_t kJournalVersion = 1;
+
+// Number of records kept, oldest being overwritten
+constexpr uint32_t kJournalCapacity = 4096;
+
+enum class JournalRecordType : uint16_t {
+    BOOT,           // service start
+    SEVERITY,       // sensor severity change
+    COOLING,        // cooling device state change
+    SUMMARY,        // sensor temperatures over a summary period
+};
+
+struct journal_record_t {
+    uint64_t            sequence;       // index since journal creation, validates the slot
+    int64_t             elapsed_ns;     // elapsed realtime
+    int64_t             realtime_ms;    // wall clock, since epoch
+    uint32_t            boot;           // service start count
+    uint16_t            type;           // JournalRecordType
+    uint16_t            reserved;
+    char                name[16];       // sensor or cooling device, truncated
+    int32_t             previous;       // SEVERITY, COOLING: previous severity or state
+    int32_t             current;        // SEVERITY, COOLING: new severity or state; SUMMARY: highest severity
+    float               value;          // SEVERITY: temperature; SUMMARY: mean
+    float               min;            // SUMMARY
+    float               max;            // SUMMARY
+    uint32_t            count;          // SUMMARY: number of samples
+};
+
+struct journal_header_t {
+    uint32_t            magic;
+    uint32_t            version;
+    uint32_t            record_size;
+    uint32_t            capacity;
+    uint32_t            boot;           // service start count
+    uint32_t            reserved;
+    uint64_t            head;           // number of records ever written
+    uint64_t            padding[4];
+};
+
+static_assert(sizeof(journal_record_t) == 72 && sizeof(journal_header_t) == 64,
+              "journal layout must not depend on the build");
+
+constexpr size_t kJournalSize = sizeof(journal_header_t) + kJournalCapacity * sizeof(journal_record_t);
+
+/**
+ * Get back a record of the journal
+ *
+ * @param header Journal header, followed by the record ring
+ * @param sequence Index of the record since journal creation
+ *
+ * @return record, or nullptr if overwritten, not written yet or torn.
+ */
+inline const journal_record_t *getJournalRecord(const journal_header_t *header, uint64_t sequence) {
+    const journal_record_t *ring = reinterpret_cast<const journal_record_t *>(header + 1);
+    const journal_record_t *record = &ring[sequence % header->capacity];
+
+    if (sequence >= header->head || header->head - sequence > header->capacity ||
+        record->sequence != sequence) {
+        return nullptr;
+    }
+    return record;
+}
+
+/**
+ * Format a record as a single line, shared by debug() and the host decoder
+ *
+ * @param record Record to be formatted
+ *
+ * @return line, without trailing newline.
+ */
+inline std::string formatJournalRecord(const journal_record_t &record) {
+    char name[sizeof(record.name) + 1] = {};
+    char line[192];
+    int len;
+
+    snprintf(name, sizeof(name), "%.*s", static_cast<int>(sizeof(record.name)), record.name);
+    len = snprintf(line, sizeof(line), "#%" PRIu64 " boot %u realtime %" PRId64 " ms elapsed %" PRId64 " ms: ",
+                   record.sequence, record.boot, record.realtime_ms, record.elapsed_ns / 1000000);
+
+    switch (static_cast<JournalRecordType>(record.type)) {
+        case JournalRecordType::BOOT:
+            snprintf(line + len, sizeof(line) - len, "service started");
+            break;
+        case JournalRecordType::SEVERITY:
+            snprintf(line + len, sizeof(line) - len, "%s severity %d -> %d at %.1f C", name,
+                     record.previous, record.current, record.value);
+            break;
+        case JournalRecordType::COOLING:
+            snprintf(line + len, sizeof(line) - len, "%s state %d -> %d", name, record.previous, record.current);
+            break;
+        case JournalRecordType::SUMMARY:
+            snprintf(line + len, sizeof(line) - len, "%s %u samples, min %.1f max %.1f mean %.2f C, severity %d",
+                     name, record.count, record.min, record.max, record.value, record.current);
+            break;
+        default:
+            snprintf(line + len, sizeof(line) - len, "unknown record type %u", record.type);
+            break;
+    }
+    return line;
+}
+
+// Service side
+
+struct thermal_snapshot_t;
+
+bool initJournal();
+void updateJournal(const thermal_snapshot_t &snapshot);
+void syncJournal();
+void dumpJournal(size_t max_records, std::string *out);
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_JOURNAL_H__
@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+#include <utils/SystemClock.h>
+
+#include "thermal-helper.h"
+#include "thermal-metrics.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::StringAppendF;
+using ::android::base::unique_fd;
+
+// Names of measured methods, in MetricsMethod order
+constexpr const char *kMetricsMethodName[kMetricsMethodNum] = {
+    "getTemperatures",
+    "getCpuUsages",
+    "getCoolingDevices",
+    "getCurrentTemperatures",
+    "getTemperatureThresholds",
+    "getCurrentCoolingDevices",
+    "registerThermalChangedCallback",
+    "unregisterThermalChangedCallback",
+    "getTelemetryMemory",
+    "getThermalState",
+    "registerThresholdCallback",
+    "unregisterThresholdCallback",
+    "getTemperatureStats",
+    "getCoolingResidency",
+    "getTemperatureHeadroom",
+};
+
+// Clients served at once, others being closed at once
+constexpr size_t kMetricsMaxClients = 8;
+constexpr int kMetricsBacklog = 4;
+
+// A client must send its request and read the response within this delay
+constexpr int64_t kMetricsClientTimeoutNs = 1000000000LL;
+
+// Maximum size of a request (an HTTP GET, or a single line)
+constexpr size_t kMetricsMaxRequest = 1024;
+
+constexpr int kMetricsMaxEvents = 16;
+
+LatencyHistogram::LatencyHistogram() : sum_ns_(0) {
+    for (int b=0; b < kLatencyBucketNum; b++) {
+        bucket_[b].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Account a method call
+ *
+ * @param latency_ns Latency, in ns
+ */
+void LatencyHistogram::record(int64_t latency_ns) {
+    int b = 0;
+
+    while (b < kLatencyBucketNum - 1 && latency_ns > kLatencyBucketUs[b] * 1000) {
+        b++;
+    }
+    bucket_[b].fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+}
+
+/**
+ * Render histogram as Prometheus cumulative buckets
+ *
+ * @param method Method name
+ * @param out Pointer to output
+ */
+void LatencyHistogram::render(const char *method, std::string *out) const {
+    uint64_t count = 0;
+
+    for (int b=0; b < kLatencyBucketNum; b++) {
+        count += bucket_[b].load(std::memory_order_relaxed);
+        if (b < kLatencyBucketNum - 1) {
+            StringAppendF(out, "thermal_method_latency_seconds_bucket{method=\"%s\",le=\"%g\"} %" PRIu64 "\n",
+                          method, kLatencyBucketUs[b] / 1e6, count);
+        } else {
+            StringAppendF(out, "thermal_method_latency_seconds_bucket{method=\"%s\",le=\"+Inf\"} %" PRIu64 "\n",
+                          method, count);
+        }
+    }
+    StringAppendF(out, "thermal_method_latency_seconds_sum{method=\"%s\"} %.9f\n", method,
+                  sum_ns_.load(std::memory_order_relaxed) / 1e9);
+    StringAppendF(out, "thermal_method_latency_seconds_count{method=\"%s\"} %" PRIu64 "\n", method, count);
+}
+
+ScopedLatency::ScopedLatency(LatencyHistogram *histogram)
+    : histogram_(histogram),
+      start_(elapsedRealtimeNano()) {}
+
+ScopedLatency::~ScopedLatency() {
+    histogram_->record(elapsedRealtimeNano() - start_);
+}
+
+MetricsServer::~MetricsServer() {
+    if (thread_.joinable()) {
+        uint64_t value = 1;
+        if (write(stop_fd_, &value, sizeof(value)) != sizeof(value)) {
+            PLOG(ERROR) << "MetricsServer: failed to stop";
+        }
+        thread_.join();
+    }
+}
+
+/**
+ * Get back latency histogram of a method
+ *
+ * @param method Method
+ *
+ * @return histogram, valid as long as the server
+ */
+LatencyHistogram *MetricsServer::getLatency(MetricsMethod method) {
+    return &latency_[static_cast<int>(method)];
+}
+
+/**
+ * Bind metrics socket and start serving
+ *
+ * @param path Path of the socket, replaced if it exists
+ *
+ * @return true on success or false on error.
+ */
+bool MetricsServer::start(const std::string &path) {
+    struct sockaddr_un addr = {};
+    struct epoll_event event = {};
+
+    if (path.size() >= sizeof(addr.sun_path)) {
+        LOG(ERROR) << "MetricsServer: socket path too long (" << path << ")";
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+
+    listen_fd_.reset(socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+    if (listen_fd_ < 0) {
+        PLOG(ERROR) << "MetricsServer: failed to create socket";
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(listen_fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        chmod(path.c_str(), 0660) < 0 || listen(listen_fd_, kMetricsBacklog) < 0) {
+        PLOG(ERROR) << "MetricsServer: failed to listen on socket (" << path << ")";
+        return false;
+    }
+
+    epoll_fd_.reset(epoll_create1(EPOLL_CLOEXEC));
+    stop_fd_.reset(eventfd(0, EFD_CLOEXEC));
+    if (epoll_fd_ < 0 || stop_fd_ < 0) {
+        PLOG(ERROR) << "MetricsServer: failed to create epoll";
+        return false;
+    }
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event) < 0) {
+        PLOG(ERROR) << "MetricsServer: failed to watch socket";
+        return false;
+    }
+    event.data.fd = stop_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &event) < 0) {
+        PLOG(ERROR) << "MetricsServer: failed to watch eventfd";
+        return false;
+    }
+
+    thread_ = std::thread(&MetricsServer::serveLoop, this);
+    LOG(INFO) << "MetricsServer: serving on " << path;
+    return true;
+}
+
+void MetricsServer::serveLoop() {
+    struct epoll_event events[kMetricsMaxEvents];
+
+    while (true) {
+        int nb_event = TEMP_FAILURE_RETRY(epoll_wait(epoll_fd_, events, kMetricsMaxEvents,
+                                                     clients_.empty() ? -1 : kMetricsClientTimeoutNs / 1000000));
+        if (nb_event < 0) {
+            PLOG(ERROR) << "MetricsServer: epoll failed";
+            return;
+        }
+
+        for (int e=0; e < nb_event; e++) {
+            int fd = events[e].data.fd;
+            if (fd == stop_fd_) {
+                return;
+            } else if (fd == listen_fd_) {
+                acceptClients();
+            } else if (clients_.count(fd) != 0) {
+                handleClient(&clients_[fd]);
+                if (clients_[fd].fd < 0) {
+                    clients_.erase(fd);
+                }
+            }
+        }
+
+        // Slow or idle clients are dropped, closing their fd removes them from epoll
+        int64_t now = elapsedRealtimeNano();
+        for (auto it = clients_.begin(); it != clients_.end();) {
+            if (now - it->second.accepted >= kMetricsClientTimeoutNs) {
+                it = clients_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void MetricsServer::acceptClients() {
+    struct epoll_event event = {};
+
+    while (true) {
+        unique_fd fd(accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                PLOG(WARNING) << "MetricsServer: failed to accept client";
+            }
+            return;
+        }
+        if (clients_.size() >= kMetricsMaxClients) {
+            continue;
+        }
+
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            PLOG(WARNING) << "MetricsServer: failed to watch client";
+            continue;
+        }
+        // A previous client of the same fd may not be erased yet
+        clients_.erase(fd.get());
+        client_t &client = clients_[fd.get()];
+        client.accepted = elapsedRealtimeNano();
+        client.sent = 0;
+        client.fd = std::move(fd);
+    }
+}
+
+/**
+ * Read request of a client, then send metrics and close the connection
+ *
+ * A request is either an HTTP GET, answered with an HTTP response, or any
+ * line, answered with metrics only.
+ *
+ * @param client Client, closed once done
+ */
+void MetricsServer::handleClient(client_t *client) {
+    char buffer[256];
+
+    if (client->response.empty()) {
+        bool eof = false;
+        while (client->request.size() < kMetricsMaxRequest) {
+            ssize_t len = read(client->fd, buffer, sizeof(buffer));
+            if (len > 0) {
+                client->request.append(buffer, len);
+            } else {
+                eof = (len == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+                break;
+            }
+        }
+
+        bool http = client->request.compare(0, 4, "GET ") == 0;
+        bool complete = http ? client->request.find("\r\n\r\n") != std::string::npos ||
+                               client->request.find("\n\n") != std::string::npos
+                             : client->request.find('\n') != std::string::npos;
+        if (!complete && !eof && client->request.size() < kMetricsMaxRequest) {
+            return;
+        }
+
+        std::string body;
+        render(&body);
+        if (http) {
+            client->response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n";
+            StringAppendF(&client->response, "Content-Length: %zu\r\nConnection: close\r\n\r\n", body.size());
+        }
+        client->response += body;
+
+        struct epoll_event event = {};
+        event.events = EPOLLOUT;
+        event.data.fd = client->fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client->fd, &event);
+    }
+
+    while (!client->response.empty() && client->sent < client->response.size()) {
+        ssize_t len = send(client->fd, client->response.data() + client->sent,
+                           client->response.size() - client->sent, MSG_NOSIGNAL);
+        if (len < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            break;
+        }
+        client->sent += len;
+    }
+    // Response sent, or client gone
+    client->fd.reset();
+}
+
+/**
+ * Escape a Prometheus label value
+ *
+ * @param value Raw value
+ *
+ * @return escaped value
+ */
+static std::string escapeLabel(const std::string &value) {
+    std::string escaped;
+
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * Render metrics from the last published snapshot
+ *
+ * @param out Pointer to output
+ */
+void MetricsServer::render(std::string *out) {
+    std::shared_ptr<const thermal_snapshot_t> snapshot = getLastSnapshot();
+
+    nb_scrape_++;
+    *out += "# TYPE thermal_scrapes_total counter\n";
+    StringAppendF(out, "thermal_scrapes_total %" PRIu64 "\n", nb_scrape_);
+    *out += "# TYPE thermal_sampling_active gauge\n";
+    StringAppendF(out, "thermal_sampling_active %d\n", sampling_active_ ? 1 : 0);
+
+    if (snapshot != nullptr) {
+        hidl_vec<Temperature_2_0> temperatures;
+        hidl_vec<RawTemperature> raw_temperatures;
+        hidl_vec<CoolingDevice_2_0> cooling_devices;
+
+        // Same view as getCurrentTemperatures() and getCurrentCoolingDevices()
+        fillTemperatures(*snapshot, false, TemperatureType::UNKNOWN, &temperatures);
+        fillTemperatures(*snapshot, false, TemperatureType::UNKNOWN, &raw_temperatures);
+        fillCoolingDevices(*snapshot, false, CoolingType_2_0::FAN, &cooling_devices);
+
+        *out += "# TYPE thermal_snapshot_timestamp_seconds gauge\n";
+        StringAppendF(out, "thermal_snapshot_timestamp_seconds %.3f\n", snapshot->timestamp / 1e9);
+
+        *out += "# TYPE thermal_temperature_celsius gauge\n";
+        for (const Temperature_2_0 &temperature : temperatures) {
+            StringAppendF(out, "thermal_temperature_celsius{sensor=\"%s\",type=\"%d\"} %.3f\n",
+                          escapeLabel(temperature.name).c_str(), static_cast<int>(temperature.type),
+                          temperature.value);
+        }
+        *out += "# TYPE thermal_raw_temperature_celsius gauge\n";
+        for (const RawTemperature &temperature : raw_temperatures) {
+            StringAppendF(out, "thermal_raw_temperature_celsius{sensor=\"%s\"} %.3f\n",
+                          escapeLabel(temperature.name).c_str(), temperature.rawValue);
+        }
+        *out += "# TYPE thermal_severity gauge\n";
+        for (const Temperature_2_0 &temperature : temperatures) {
+            StringAppendF(out, "thermal_severity{sensor=\"%s\"} %d\n", escapeLabel(temperature.name).c_str(),
+                          static_cast<int>(temperature.throttlingStatus));
+        }
+        *out += "# TYPE thermal_cooling_state gauge\n";
+        for (const CoolingDevice_2_0 &cooling : cooling_devices) {
+            StringAppendF(out, "thermal_cooling_state{device=\"%s\",type=\"%d\"} %" PRIu64 "\n",
+                          escapeLabel(cooling.name).c_str(), static_cast<int>(cooling.type), cooling.value);
+        }
+        *out += "# TYPE thermal_read_errors_total counter\n";
+        StringAppendF(out, "thermal_read_errors_total{source=\"temperature\"} %" PRIu64 "\n",
+                      snapshot->nb_temperature_error);
+        StringAppendF(out, "thermal_read_errors_total{source=\"cooling\"} %" PRIu64 "\n",
+                      snapshot->nb_cooling_error);
+    }
+
+    *out += "# TYPE thermal_method_latency_seconds histogram\n";
+    for (int m=0; m < kMetricsMethodNum; m++) {
+        latency_[m].render(kMetricsMethodName[m], out);
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
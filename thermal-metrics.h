@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_METRICS_H__
+#define __THERMAL_METRICS_H__
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <android-base/unique_fd.h>
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Path of the metrics socket, endpoint being disabled if not set
+constexpr const char *kMetricsSocketProperty = "ro.vendor.thermal.metrics_socket";
+
+// Service methods whose latency is measured
+enum class MetricsMethod : int {
+    GET_TEMPERATURES,
+    GET_CPU_USAGES,
+    GET_COOLING_DEVICES,
+    GET_CURRENT_TEMPERATURES,
+    GET_TEMPERATURE_THRESHOLDS,
+    GET_CURRENT_COOLING_DEVICES,
+    REGISTER_THERMAL_CHANGED_CALLBACK,
+    UNREGISTER_THERMAL_CHANGED_CALLBACK,
+    GET_TELEMETRY_MEMORY,
+    GET_THERMAL_STATE,
+    REGISTER_THRESHOLD_CALLBACK,
+    UNREGISTER_THRESHOLD_CALLBACK,
+    GET_TEMPERATURE_STATS,
+    GET_COOLING_RESIDENCY,
+    GET_TEMPERATURE_HEADROOM,
+    NUM,
+};
+
+constexpr int kMetricsMethodNum = static_cast<int>(MetricsMethod::NUM);
+
+// Upper bounds of latency histogram buckets, in us (last bucket is +Inf)
+constexpr int64_t kLatencyBucketUs[] = {10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 100000};
+constexpr int kLatencyBucketNum = sizeof(kLatencyBucketUs) / sizeof(kLatencyBucketUs[0]) + 1;
+
+// Latency histogram, updated lock-free by binder threads
+class LatencyHistogram {
+  public:
+    LatencyHistogram();
+
+    void record(int64_t latency_ns);
+    void render(const char *method, std::string *out) const;
+
+  private:
+    std::atomic<uint64_t> bucket_[kLatencyBucketNum];
+    std::atomic<uint64_t> sum_ns_;
+};
+
+// Serves metrics in Prometheus text format on a Unix domain socket, from a
+// single thread running a non-blocking epoll loop. Metrics are rendered from
+// the last published snapshot: a scrape never reads sysfs nor takes the
+// sampling lock.
+class MetricsServer {
+  public:
+    MetricsServer() = default;
+    ~MetricsServer();
+
+    bool start(const std::string &path);
+    LatencyHistogram *getLatency(MetricsMethod method);
+    void setSamplingActive(bool active) { sampling_active_ = active; }
+
+  private:
+    struct client_t {
+        android::base::unique_fd fd;
+        int64_t accepted;               // boot time in ns, for timeout
+        std::string request;
+        std::string response;
+        size_t sent;
+    };
+
+    void serveLoop();
+    void acceptClients();
+    void handleClient(client_t *client);
+    void render(std::string *out);
+
+    LatencyHistogram latency_[kMetricsMethodNum];
+    uint64_t nb_scrape_ = 0;
+    // Last sample is not updated while periodic sampling is stopped
+    std::atomic<bool> sampling_active_ = false;
+
+    android::base::unique_fd listen_fd_;
+    android::base::unique_fd epoll_fd_;
+    android::base::unique_fd stop_fd_;
+    std::unordered_map<int, client_t> clients_;     // keyed by fd, only used by serving thread
+    std::thread thread_;
+};
+
+// Measures latency of a method, from construction to destruction
+class ScopedLatency {
+  public:
+    explicit ScopedLatency(LatencyHistogram *histogram);
+    ~ScopedLatency();
+
+  private:
+    LatencyHistogram *histogram_;
+    int64_t start_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_METRICS_H__
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_PROFILE_H__
+#define __THERMAL_PROFILE_H__
+
+#include <android/hardware/thermal/2.0/IThermal.h>
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using CoolingType_2_0 = ::android::hardware::thermal::V2_0::CoolingType;
+using ::android::hardware::thermal::V2_0::TemperatureType;
+using ::android::hardware::thermal::V2_0::ThrottlingSeverity;
+
+// Sensor of a board profile (physical sensor only)
+struct sensor_profile_t {
+    const char          *name;
+    TemperatureType     type;
+    const char          *zone_type;     // kernel thermal zone type (none = no driver)
+};
+
+// Cooling device of a board profile
+struct cooling_profile_t {
+    const char          *name;
+    CoolingType_2_0     type;
+    const char          *cooling_type;  // kernel cooling device type (none = no driver)
+};
+
+// Action taken by the emergency path, once subscribers are notified
+enum class EmergencyAction : uint32_t {
+    NONE,           // notification only
+    SHUTDOWN,       // orderly shutdown of the board
+};
+
+/*
+ * A board profile fixes at compile time:
+ * - kRuntimeConfig: if true, configuration is read from file, profile tables being the default
+ * - kThermalZoneStub, kCoolingDeviceStub: if true, stub values returned if not available
+ *   on kernel side, stub code being removed otherwise
+ * - kUnrolled: if true, loops on samples are unrolled up to kMaxSensors
+ * - kCpuNum: number of CPUs whose usage is reported
+ * - kMaxSensors, kMaxCoolingNames: capacity of configurations
+ * - kSensor, kCooling: sensors and cooling devices of the board
+ * - kEmergencyAction, kEmergencyActionSeverity: action taken when a sensor reaches
+ *   severity (EMERGENCY or SHUTDOWN)
+ */
+
+/* Generic build: CPU0, CPU1, GPU, BATTERY, SKIN and FAN, CPU, configurable at runtime */
+struct GenericProfile {
+    static constexpr bool kRuntimeConfig = true;
+    static constexpr bool kThermalZoneStub = true;
+    static constexpr bool kCoolingDeviceStub = true;
+    static constexpr bool kUnrolled = false;
+
+    static constexpr unsigned int kCpuNum = 2;
+    static constexpr unsigned int kMaxSensors = 8;
+    static constexpr unsigned int kMaxCoolingNames = 4;
+
+    static constexpr unsigned int kSensorNum = 5;
+    static constexpr sensor_profile_t kSensor[kSensorNum] = {
+        {"CPU0", TemperatureType::CPU, "cpu0-thermal"},
+        {"CPU1", TemperatureType::CPU, "cpu1-thermal"},
+        {"GPU", TemperatureType::GPU, "cpu0-thermal"},
+        {"BATTERY", TemperatureType::BATTERY, "dummy-battery"},
+        {"SKIN", TemperatureType::SKIN, "none"},
+    };
+
+    static constexpr unsigned int kCoolingNum = 2;
+    static constexpr cooling_profile_t kCooling[kCoolingNum] = {
+        {"FAN", CoolingType_2_0::FAN, "none"},
+        {"CPU", CoolingType_2_0::CPU, "thermal-cpufreq-0"},
+    };
+
+    static constexpr EmergencyAction kEmergencyAction = EmergencyAction::NONE;
+    static constexpr ThrottlingSeverity kEmergencyActionSeverity = ThrottlingSeverity::SHUTDOWN;
+};
+
+/* STM32MP13: single Cortex-A7, no GPU, one temperature sensor */
+struct Stm32mp13Profile {
+    static constexpr bool kRuntimeConfig = false;
+    static constexpr bool kThermalZoneStub = false;
+    static constexpr bool kCoolingDeviceStub = false;
+    static constexpr bool kUnrolled = true;
+
+    static constexpr unsigned int kCpuNum = 1;
+
+    static constexpr unsigned int kSensorNum = 1;
+    static constexpr sensor_profile_t kSensor[kSensorNum] = {
+        {"CPU", TemperatureType::CPU, "cpu-thermal"},
+    };
+
+    static constexpr unsigned int kCoolingNum = 1;
+    static constexpr cooling_profile_t kCooling[kCoolingNum] = {
+        {"CPU", CoolingType_2_0::CPU, "thermal-cpufreq-0"},
+    };
+
+    static constexpr EmergencyAction kEmergencyAction = EmergencyAction::NONE;
+    static constexpr ThrottlingSeverity kEmergencyActionSeverity = ThrottlingSeverity::SHUTDOWN;
+
+    static constexpr unsigned int kMaxSensors = kSensorNum;
+    static constexpr unsigned int kMaxCoolingNames = kCoolingNum;
+};
+
+/* STM32MP15: dual Cortex-A7 and GPU, sharing one temperature sensor */
+struct Stm32mp15Profile {
+    static constexpr bool kRuntimeConfig = false;
+    static constexpr bool kThermalZoneStub = false;
+    static constexpr bool kCoolingDeviceStub = false;
+    static constexpr bool kUnrolled = true;
+
+    static constexpr unsigned int kCpuNum = 2;
+
+    static constexpr unsigned int kSensorNum = 3;
+    static constexpr sensor_profile_t kSensor[kSensorNum] = {
+        {"CPU0", TemperatureType::CPU, "cpu-thermal"},
+        {"CPU1", TemperatureType::CPU, "cpu-thermal"},
+        {"GPU", TemperatureType::GPU, "cpu-thermal"},
+    };
+
+    static constexpr unsigned int kCoolingNum = 1;
+    static constexpr cooling_profile_t kCooling[kCoolingNum] = {
+        {"CPU", CoolingType_2_0::CPU, "thermal-cpufreq-0"},
+    };
+
+    static constexpr EmergencyAction kEmergencyAction = EmergencyAction::NONE;
+    static constexpr ThrottlingSeverity kEmergencyActionSeverity = ThrottlingSeverity::SHUTDOWN;
+
+    static constexpr unsigned int kMaxSensors = kSensorNum;
+    static constexpr unsigned int kMaxCoolingNames = kCoolingNum;
+};
+
+/* STM32MP25: dual Cortex-A35 and GPU */
+struct Stm32mp25Profile {
+    static constexpr bool kRuntimeConfig = false;
+    static constexpr bool kThermalZoneStub = false;
+    static constexpr bool kCoolingDeviceStub = false;
+    static constexpr bool kUnrolled = true;
+
+    static constexpr unsigned int kCpuNum = 2;
+
+    static constexpr unsigned int kSensorNum = 3;
+    static constexpr sensor_profile_t kSensor[kSensorNum] = {
+        {"CPU0", TemperatureType::CPU, "cpu0-thermal"},
+        {"CPU1", TemperatureType::CPU, "cpu1-thermal"},
+        {"GPU", TemperatureType::GPU, "cpu0-thermal"},
+    };
+
+    static constexpr unsigned int kCoolingNum = 1;
+    static constexpr cooling_profile_t kCooling[kCoolingNum] = {
+        {"CPU", CoolingType_2_0::CPU, "thermal-cpufreq-0"},
+    };
+
+    static constexpr EmergencyAction kEmergencyAction = EmergencyAction::NONE;
+    static constexpr ThrottlingSeverity kEmergencyActionSeverity = ThrottlingSeverity::SHUTDOWN;
+
+    static constexpr unsigned int kMaxSensors = kSensorNum;
+    static constexpr unsigned int kMaxCoolingNames = kCoolingNum;
+};
+
+// Board profile selected by build (see thermal_board_profile in Android.bp)
+#if defined(THERMAL_BOARD_PROFILE_STM32MP13)
+using BoardProfile = Stm32mp13Profile;
+#elif defined(THERMAL_BOARD_PROFILE_STM32MP15)
+using BoardProfile = Stm32mp15Profile;
+#elif defined(THERMAL_BOARD_PROFILE_STM32MP25)
+using BoardProfile = Stm32mp25Profile;
+#else
+using BoardProfile = GenericProfile;
+#endif
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_PROFILE_H__
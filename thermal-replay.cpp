@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replays a trace of sensor reads through the sampling engine (filters,
+// virtual sensors, thresholds), e.g. to check a configuration change:
+//   adb pull /data/vendor/thermal/trace.bin && thermal-replay thermal-config.json trace.bin > samples.csv
+// The configuration must be the one the trace was recorded with.
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "thermal-config.h"
+#include "thermal-helper.h"
+#include "thermal-source.h"
+
+using namespace ::android::hardware::thermal::V2_0::implementation;
+
+int main(int argc, char *argv[]) {
+    bool realtime = (argc == 4 && strcmp(argv[3], "--realtime") == 0);
+
+    if (argc != 3 && !realtime) {
+        fprintf(stderr, "Usage: %s <config file> <trace file> [--realtime]\n", argv[0]);
+        return 1;
+    }
+
+    std::shared_ptr<const thermal_config_t> config = parseThermalConfig(argv[1]);
+    if (config == nullptr) {
+        fprintf(stderr, "%s: invalid configuration\n", argv[1]);
+        return 1;
+    }
+
+    std::shared_ptr<ReplaySource> source = std::make_shared<ReplaySource>(realtime);
+    if (!source->open(argv[2], getConfigChecksum(*config))) {
+        fprintf(stderr, "%s: invalid trace, or recorded with another configuration\n", argv[2]);
+        return 1;
+    }
+    setThermalSource(source);
+    if (!initThermal(config)) {
+        fprintf(stderr, "%s: failed to initialize thermal\n", argv[2]);
+        return 1;
+    }
+
+    ThrottlingSeverity severity[kMaxSensors] = {};
+    size_t nb_sample = 0;
+    size_t nb_transition = 0;
+    std::chrono::steady_clock::duration elapsed(0);
+
+    printf("timestamp_ms,sensor,raw,value,severity\n");
+    while (!source->done()) {
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<const thermal_snapshot_t> snapshot = sampleThermal();
+        elapsed += std::chrono::steady_clock::now() - start;
+        nb_sample++;
+
+        for (int i=0; i < snapshot->nb_temperature; i++) {
+            const temperature_sample_t &sample = snapshot->temperature[i];
+            if (nb_sample > 1 && sample.severity != severity[sample.name]) {
+                nb_transition++;
+            }
+            severity[sample.name] = sample.severity;
+            printf("%" PRId64 ",%s,%.3f,%.3f,%s\n", snapshot->timestamp / 1000000,
+                   config->sensor[sample.name].name, sample.raw_value, sample.value,
+                   toString(sample.severity).c_str());
+        }
+    }
+
+    int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    fprintf(stderr, "%zu samples, %zu severity transitions, %.1f us per sample\n", nb_sample, nb_transition,
+            nb_sample > 0 ? static_cast<double>(elapsed_us) / nb_sample : 0.0);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "thermal-residency.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+/**
+ * Account a periodic sample of cooling devices
+ *
+ * @param snapshot New sample, newer than all previous ones
+ */
+void ResidencyCollector::update(const thermal_snapshot_t &snapshot) {
+    const cooling_device_t &cooling = snapshot.topology->cooling;
+
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    for (auto &entry : coolings_) {
+        entry.second.sampled = false;
+    }
+
+    for (int i=0; i < snapshot.nb_cooling; i++) {
+        const cooling_sample_t &sample = snapshot.cooling[i];
+        cooling_residency_t &residency = coolings_[cooling.cooling_type[sample.cooling]];
+        int state = std::clamp(static_cast<int>(sample.value), 0, kMaxCoolingState);
+
+        // Histogram covers all states declared by driver, or all states seen if unknown
+        int max_state = std::min(cooling.max_state[sample.cooling], kMaxCoolingState);
+        size_t size = std::max(max_state, state) + 1;
+        if (residency.residency_ns.size() < size) {
+            residency.residency_ns.resize(size);
+            residency.entries.resize(size);
+        }
+
+        if (residency.timestamp != 0) {
+            residency.residency_ns[residency.state] += snapshot.timestamp - residency.timestamp;
+        }
+        if (state != residency.state) {
+            residency.entries[state]++;
+            if (residency.state >= 0) {
+                residency.transitions++;
+            }
+        }
+        residency.state = state;
+        residency.timestamp = snapshot.timestamp;
+        residency.sampled = true;
+    }
+
+    // Time a device was not sampled (read error, removed) is not accounted,
+    // its last state being kept to only count an entry on a state change
+    for (auto &entry : coolings_) {
+        if (!entry.second.sampled) {
+            entry.second.timestamp = 0;
+        }
+    }
+}
+
+/**
+ * Restart accounting from next sample, time until then being charged to no state
+ * and last state being kept
+ */
+void ResidencyCollector::restart() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    for (auto &entry : coolings_) {
+        entry.second.timestamp = 0;
+    }
+}
+
+/**
+ * Get back residency of cooling devices
+ *
+ * @param residencies Pointer to residencies, sorted by cooling device type
+ */
+void ResidencyCollector::getResidency(hidl_vec<CoolingResidency> *residencies) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+    size_t num = 0;
+
+    residencies->resize(coolings_.size());
+    for (const auto &entry : coolings_) {
+        const cooling_residency_t &residency = entry.second;
+        CoolingResidency &out = (*residencies)[num++];
+        out.name = entry.first;
+        out.maxState = residency.residency_ns.size() - 1;
+        out.currentState = residency.state;
+        out.residencyMs.resize(residency.residency_ns.size());
+        for (size_t s=0; s < residency.residency_ns.size(); s++) {
+            out.residencyMs[s] = residency.residency_ns[s] / 1000000;
+        }
+        out.entries = residency.entries;
+        out.transitions = residency.transitions;
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
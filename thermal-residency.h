@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_RESIDENCY_H__
+#define __THERMAL_RESIDENCY_H__
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <vendor/stm32mpu/hardware/thermal/1.0/types.h>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::vendor::stm32mpu::hardware::thermal::V1_0::CoolingResidency;
+
+// Highest cooling device state accounted, higher states being counted as this one
+constexpr int kMaxCoolingState = 63;
+
+// Time spent by cooling devices in each state, and state changes, accounted
+// at each periodic sample: time elapsed since previous sample is charged to
+// the state of previous sample. Time periodic sampling was stopped is not
+// accounted, but a state change across it is.
+class ResidencyCollector {
+  public:
+    ResidencyCollector() = default;
+
+    void update(const thermal_snapshot_t &snapshot);
+    void restart();
+    void getResidency(hidl_vec<CoolingResidency> *residencies);
+
+  private:
+    struct cooling_residency_t {
+        int                     state = -1;     // state of last sample, -1 if never sampled
+        int64_t                 timestamp = 0;  // last sample, 0 if time since then is not accounted
+        bool                    sampled;        // in sample being accounted
+        std::vector<int64_t>    residency_ns;   // indexed by state
+        std::vector<uint32_t>   entries;
+        uint32_t                transitions;
+    };
+
+    std::mutex mutex_;
+    // Keyed by kernel cooling device type, kept across topology changes
+    std::map<std::string, cooling_residency_t> coolings_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_RESIDENCY_H__
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <android-base/logging.h>
+
+#include "thermal-sampling.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+SamplingScheduler::SamplingScheduler() : slack_ns_(-1) {}
+
+/**
+ * Create timer and wake event, waits falling back to polling if any is missing
+ *
+ * @return true on success or false on error.
+ */
+bool SamplingScheduler::init() {
+    bool ret = true;
+
+    wake_fd_.reset(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    if (wake_fd_ < 0) {
+        PLOG(ERROR) << "SamplingScheduler: failed to create eventfd";
+        ret = false;
+    }
+    // Not CLOCK_BOOTTIME_ALARM: expiry during suspend does not wake the system
+    timer_fd_.reset(timerfd_create(CLOCK_BOOTTIME, TFD_NONBLOCK | TFD_CLOEXEC));
+    if (timer_fd_ < 0) {
+        PLOG(ERROR) << "SamplingScheduler: failed to create timer";
+        ret = false;
+    }
+    return ret;
+}
+
+/**
+ * End current or next wait (any thread)
+ */
+void SamplingScheduler::wake() {
+    uint64_t value = 1;
+
+    // Waits are bounded when there is no wake event
+    if (wake_fd_ < 0) {
+        return;
+    }
+    if (write(wake_fd_, &value, sizeof(value)) != sizeof(value)) {
+        PLOG(ERROR) << "SamplingScheduler: failed to wake";
+    }
+}
+
+/**
+ * Wait until timeout, resume from a long enough suspend, or wake() (monitor thread only)
+ *
+ * @param timeout_ns Timeout, in ns, or -1 to only wait for wake()
+ * @param slack_ns Delay a wakeup may be deferred by, to be coalesced
+ */
+void SamplingScheduler::wait(int64_t timeout_ns, int64_t slack_ns) {
+    struct itimerspec spec = {};
+    struct pollfd fds[] = {
+        {.fd = wake_fd_, .events = POLLIN},
+        {.fd = timer_fd_, .events = POLLIN},
+    };
+    uint64_t value;
+
+    if (slack_ns != slack_ns_ && slack_ns > 0) {
+        if (prctl(PR_SET_TIMERSLACK, static_cast<unsigned long>(slack_ns)) < 0) {
+            PLOG(WARNING) << "SamplingScheduler: failed to set timer slack";
+        }
+        slack_ns_ = slack_ns;
+    }
+
+    // Timer is disarmed when waiting for wake() only
+    if (timeout_ns >= 0) {
+        int64_t expiry_ns = timeout_ns + std::max<int64_t>(slack_ns, 0) + 1;
+        spec.it_value.tv_sec = expiry_ns / 1000000000LL;
+        spec.it_value.tv_nsec = expiry_ns % 1000000000LL;
+    }
+    if (timer_fd_ >= 0 && timerfd_settime(timer_fd_, 0, &spec, nullptr) < 0) {
+        PLOG(ERROR) << "SamplingScheduler: failed to arm timer";
+    }
+
+    int timeout_ms = timeout_ns < 0 ? -1 : static_cast<int>((timeout_ns + 999999) / 1000000);
+    // Without wake event, wake() requests are only seen by polling
+    if (wake_fd_ < 0 && (timeout_ms < 0 || timeout_ms > kSamplingFallbackPollMs)) {
+        timeout_ms = kSamplingFallbackPollMs;
+    }
+    if (TEMP_FAILURE_RETRY(poll(fds, 2, timeout_ms)) < 0) {
+        PLOG(ERROR) << "SamplingScheduler: poll failed";
+    }
+
+    // Both are non-blocking, and only drained here
+    if (wake_fd_ >= 0 && read(wake_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        PLOG(ERROR) << "SamplingScheduler: failed to read eventfd";
+    }
+    if (timer_fd_ >= 0 && read(timer_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        PLOG(ERROR) << "SamplingScheduler: failed to read timer";
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_SAMPLING_H__
+#define __THERMAL_SAMPLING_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include <android-base/unique_fd.h>
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Timer slack of periodic sampling, in percent of the polling period
+constexpr int64_t kSamplingSlackPercent = 20;
+
+// Longest wait when the wake event is not available, in ms
+constexpr int kSamplingFallbackPollMs = 1000;
+
+// Polling periods sampling stays on after a request whose client can't be
+// tracked (telemetry region, headroom), renewed by each request
+constexpr int64_t kSamplingLeasePeriods = 30;
+
+// Demands for periodic sampling, by source
+struct sampling_demand_t {
+    size_t              callbacks;      // registered throttling callbacks
+    size_t              subscriptions;  // custom threshold subscriptions
+    size_t              telemetry;      // 1 while a client recently got the telemetry region
+    size_t              headroom;       // 1 while a client recently got headroom
+    size_t              actuators;      // enabled actuators (uclamp advisor, emergency action)
+
+    size_t total() const { return callbacks + subscriptions + telemetry + headroom + actuators; }
+};
+
+// Waits of the monitor thread between two samples. Waits never wake the
+// system from suspend and no wakelock is held: the wait timeout honours the
+// thread timer slack so that wakeups coalesce with other timers, and is
+// bounded by a CLOCK_BOOTTIME timer expiring slack later. As CLOCK_BOOTTIME
+// counts time spent suspended, that timer expires right after a resume which
+// outlasted the deadline, giving one immediate catch-up sample.
+class SamplingScheduler {
+  public:
+    SamplingScheduler();
+
+    bool init();
+    void wake();
+    void wait(int64_t timeout_ns, int64_t slack_ns);
+
+  private:
+    android::base::unique_fd timer_fd_;
+    android::base::unique_fd wake_fd_;
+    int64_t slack_ns_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_SAMPLING_H__
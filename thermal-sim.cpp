@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs the sampling engine in closed loop on a simulated thermal model, on a
+// virtual clock, e.g. to tune filters and thresholds against an hour of load:
+//   thermal-sim thermal-config.json thermal-model.json 3600 > notifications.csv
+// Notification latency is counted from the sample whose unfiltered value
+// reached the notified severity.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "thermal-config.h"
+#include "thermal-helper.h"
+#include "thermal-simulator.h"
+
+using namespace ::android::hardware::thermal::V2_0::implementation;
+
+int main(int argc, char *argv[]) {
+    if (argc != 4 || atoi(argv[3]) <= 0) {
+        fprintf(stderr, "Usage: %s <config file> <model file> <duration s>\n", argv[0]);
+        return 1;
+    }
+    int64_t duration_ns = atoll(argv[3]) * 1000000000LL;
+
+    std::shared_ptr<const thermal_config_t> config = parseThermalConfig(argv[1]);
+    if (config == nullptr) {
+        fprintf(stderr, "%s: invalid configuration\n", argv[1]);
+        return 1;
+    }
+
+    std::shared_ptr<SimulatedSource> source = std::make_shared<SimulatedSource>();
+    if (!source->load(argv[2], *config)) {
+        fprintf(stderr, "%s: invalid model\n", argv[2]);
+        return 1;
+    }
+    setThermalSource(source);
+    if (!initThermal(config)) {
+        fprintf(stderr, "%s: failed to initialize thermal\n", argv[2]);
+        return 1;
+    }
+
+    // Time each sensor reached its current unfiltered severity
+    ThrottlingSeverity raw_severity[kMaxSensors] = {};
+    int64_t raw_timestamp[kMaxSensors] = {};
+    size_t nb_sample = 0;
+    size_t nb_notification = 0;
+    size_t nb_latency = 0;
+    int64_t total_latency_ns = 0;
+    int64_t max_latency_ns = 0;
+    std::chrono::steady_clock::duration elapsed(0);
+
+    std::shared_ptr<const thermal_snapshot_t> previous = sampleThermal();
+    printf("timestamp_ms,sensor,value,severity,latency_ms\n");
+    while (previous->timestamp < duration_ns) {
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<const thermal_snapshot_t> snapshot = sampleThermal();
+        hidl_vec<Temperature_2_0> temperatures;
+        fillThrottlingChanges(*previous, *snapshot, &temperatures);
+        elapsed += std::chrono::steady_clock::now() - start;
+        nb_sample++;
+
+        for (int i=0; i < snapshot->nb_temperature; i++) {
+            const temperature_sample_t &sample = snapshot->temperature[i];
+            ThrottlingSeverity severity = getSeverity(snapshot->thresholds->all[sample.sensor], sample.raw_value,
+                                                      ThrottlingSeverity::NONE, 0);
+            if (severity != raw_severity[sample.name]) {
+                raw_severity[sample.name] = severity;
+                raw_timestamp[sample.name] = snapshot->timestamp;
+            }
+        }
+        for (int i=0; i < snapshot->nb_temperature; i++) {
+            const temperature_sample_t &sample = snapshot->temperature[i];
+            const char *name = config->sensor[sample.name].name;
+            for (const Temperature_2_0 &temperature : temperatures) {
+                if (temperature.name != name) {
+                    continue;
+                }
+                // Severity reached through hysteresis has no latency
+                int64_t latency_ns = -1;
+                if (temperature.throttlingStatus == raw_severity[sample.name]) {
+                    latency_ns = snapshot->timestamp - raw_timestamp[sample.name];
+                    total_latency_ns += latency_ns;
+                    max_latency_ns = std::max(max_latency_ns, latency_ns);
+                    nb_latency++;
+                }
+                nb_notification++;
+                printf("%" PRId64 ",%s,%.3f,%s,%" PRId64 "\n", snapshot->timestamp / 1000000, name,
+                       temperature.value, toString(temperature.throttlingStatus).c_str(),
+                       latency_ns < 0 ? -1 : latency_ns / 1000000);
+            }
+        }
+        previous = snapshot;
+    }
+
+    int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    fprintf(stderr, "%" PRId64 " s simulated in %.3f s, %zu samples, %.1f us per sample\n",
+            previous->timestamp / 1000000000, elapsed_us / 1e6, nb_sample,
+            nb_sample > 0 ? static_cast<double>(elapsed_us) / nb_sample : 0.0);
+    fprintf(stderr, "%zu notifications, latency mean %" PRId64 " ms, max %" PRId64 " ms\n", nb_notification,
+            nb_latency > 0 ? total_latency_ns / static_cast<int64_t>(nb_latency) / 1000000 : 0,
+            max_latency_ns / 1000000);
+    return 0;
+}
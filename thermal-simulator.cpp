@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <android-base/logging.h>
+#include <json/reader.h>
+#include <json/value.h>
+
+#include "thermal-simulator.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+/**
+ * Copy a JSON string to a fixed size name
+ *
+ * @return true on success or false if value is not a string or too long.
+ */
+static bool parseName(const Json::Value &value, char *name, size_t size) {
+    if (!value.isString() || value.asString().empty() || value.asString().size() >= size) {
+        return false;
+    }
+    strcpy(name, value.asCString());
+    return true;
+}
+
+/**
+ * Derive power dissipated in a thermal zone from its temperatures in a read trace
+ *
+ * Inverts the RC model between two successive reads: P = C.dT/dt + (T - Ta)/R.
+ *
+ * @param path Path of the trace
+ * @param temperature_mult Multiplier from kernel unit to Celsius
+ * @param ambient Ambient temperature, in Celsius
+ * @param zone Pointer to simulated zone, whose power and initial temperature are set
+ *
+ * @return true on success or false if the trace holds less than two reads of the zone.
+ */
+static bool loadTracePower(const std::string &path, float temperature_mult, float ambient, sim_zone_t *zone) {
+    std::ifstream stream(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(trace_header_t)) {
+        return false;
+    }
+    const trace_header_t *header = reinterpret_cast<const trace_header_t *>(data.data());
+    if (header->magic != kTraceMagic || header->version != kTraceVersion ||
+        header->topology_size != sizeof(thermal_topology_t)) {
+        return false;
+    }
+
+    int zone_id = -1;
+    for (int i=0; i < header->topology.zone.nb_zone; i++) {
+        if (strcmp(header->topology.zone.zone_type[i], zone->zone_type) == 0) {
+            zone_id = header->topology.zone.zone_id[i];
+        }
+    }
+
+    const trace_record_t *records = reinterpret_cast<const trace_record_t *>(data.data() + sizeof(trace_header_t));
+    size_t nb_record = (data.size() - sizeof(trace_header_t)) / sizeof(trace_record_t);
+    const trace_record_t *last = nullptr;
+    zone->power.clear();
+    for (size_t n=0; zone_id >= 0 && n < nb_record; n++) {
+        const trace_record_t &record = records[n];
+        if (record.source != static_cast<uint8_t>(TraceSource::ZONE_TEMP) || record.id != zone_id ||
+            record.error != 0) {
+            continue;
+        }
+        if (last == nullptr) {
+            zone->temperature = record.raw * temperature_mult;
+        } else if (record.timestamp > last->timestamp) {
+            float delta = (record.raw - last->raw) * temperature_mult;
+            float temperature = last->raw * temperature_mult;
+            sim_power_step_t step;
+            step.duration_ns = record.timestamp - last->timestamp;
+            step.watts = zone->capacitance * delta * 1e9 / step.duration_ns +
+                         (temperature - ambient) / zone->resistance;
+            zone->power.push_back(step);
+        }
+        last = &record;
+    }
+    return !zone->power.empty();
+}
+
+SimulatedSource::SimulatedSource()
+    : ambient_(kSimulationAmbient),
+      temperature_mult_(1),
+      step_ns_(kSimulationSubstepNs),
+      now_(0),
+      nb_zone_(0),
+      nb_cooling_(0) {}
+
+/**
+ * Load a thermal model
+ *
+ * @param path Path of the model file
+ * @param config Board configuration giving the polling period and temperature unit
+ *
+ * @return true on success or false on error.
+ */
+bool SimulatedSource::load(const std::string &path, const thermal_config_t &config) {
+    Json::CharReaderBuilder builder;
+    Json::Value root;
+    std::string errors;
+
+    std::ifstream stream(path);
+    if (!stream.is_open()) {
+        LOG(ERROR) << "SimulatedSource: failed to open " << path;
+        return false;
+    }
+    if (!Json::parseFromStream(builder, stream, &root, &errors)) {
+        LOG(ERROR) << "SimulatedSource: failed to parse " << path << ": " << errors;
+        return false;
+    }
+
+    ambient_ = root.get("Ambient", kSimulationAmbient).asFloat();
+    temperature_mult_ = config.temperature_mult;
+    step_ns_ = config.polling_period_ns;
+    now_ = 0;
+
+    const Json::Value &zones = root["Zones"];
+    if (!zones.isArray() || zones.size() == 0 || zones.size() > kMaxThermalZones) {
+        LOG(ERROR) << "SimulatedSource: expecting 1 to " << kMaxThermalZones << " zones";
+        return false;
+    }
+    nb_zone_ = 0;
+    for (const Json::Value &value : zones) {
+        sim_zone_t &zone = zone_[nb_zone_];
+        if (!parseName(value["ZoneType"], zone.zone_type, sizeof(zone.zone_type))) {
+            LOG(ERROR) << "SimulatedSource: invalid zone type";
+            return false;
+        }
+        zone.resistance = value.get("Resistance", 0).asFloat();
+        zone.capacitance = value.get("Capacitance", 0).asFloat();
+        zone.temperature = value.get("Temperature", ambient_).asFloat();
+        if (!(zone.resistance > 0) || !(zone.capacitance > 0)) {
+            LOG(ERROR) << "SimulatedSource: invalid resistance or capacitance for zone " << zone.zone_type;
+            return false;
+        }
+
+        const Json::Value &trips = value["Trips"];
+        if (!trips.isNull() && (!trips.isArray() || trips.size() > kMaxThermalTrip)) {
+            LOG(ERROR) << "SimulatedSource: expecting at most " << kMaxThermalTrip << " trips for zone "
+                       << zone.zone_type;
+            return false;
+        }
+        zone.nb_trip = 0;
+        for (const Json::Value &trip : trips) {
+            if (!parseName(trip["Type"], zone.trip_type[zone.nb_trip], sizeof(zone.trip_type[0])) ||
+                !trip["Temperature"].isNumeric()) {
+                LOG(ERROR) << "SimulatedSource: invalid trip for zone " << zone.zone_type;
+                return false;
+            }
+            zone.trip_temperature[zone.nb_trip] = trip["Temperature"].asFloat();
+            zone.nb_trip++;
+        }
+
+        // Power is either synthetic, or derived from a recorded trace
+        const Json::Value &power = value["Power"];
+        const Json::Value &trace = value["PowerTrace"];
+        zone.power.clear();
+        if (trace.isString()) {
+            if (!loadTracePower(trace.asString(), temperature_mult_, ambient_, &zone)) {
+                LOG(ERROR) << "SimulatedSource: no read of zone " << zone.zone_type << " in " << trace.asString();
+                return false;
+            }
+        } else if (power.isArray()) {
+            for (const Json::Value &entry : power) {
+                sim_power_step_t step;
+                step.duration_ns = entry.get("DurationMs", 0).asInt64() * 1000000;
+                step.watts = entry.get("Watts", 0).asFloat();
+                if (step.duration_ns <= 0) {
+                    LOG(ERROR) << "SimulatedSource: invalid power duration for zone " << zone.zone_type;
+                    return false;
+                }
+                zone.power.push_back(step);
+            }
+        }
+        if (zone.power.empty()) {
+            LOG(ERROR) << "SimulatedSource: no power for zone " << zone.zone_type;
+            return false;
+        }
+        zone.power_period_ns = 0;
+        for (const sim_power_step_t &step : zone.power) {
+            zone.power_period_ns += step.duration_ns;
+        }
+        last_temperature_[nb_zone_] = zone.temperature;
+        nb_zone_++;
+    }
+
+    const Json::Value &coolings = root["CoolingDevices"];
+    if (!coolings.isNull() && (!coolings.isArray() || coolings.size() > kMaxCoolingDevices)) {
+        LOG(ERROR) << "SimulatedSource: expecting at most " << kMaxCoolingDevices << " cooling devices";
+        return false;
+    }
+    nb_cooling_ = 0;
+    for (const Json::Value &value : coolings) {
+        sim_cooling_t &cooling = cooling_[nb_cooling_];
+        char zone_type[32];
+        if (!parseName(value["CoolingType"], cooling.cooling_type, sizeof(cooling.cooling_type)) ||
+            !parseName(value["Zone"], zone_type, sizeof(zone_type))) {
+            LOG(ERROR) << "SimulatedSource: invalid cooling device";
+            return false;
+        }
+        cooling.zone = -1;
+        for (int i=0; i < nb_zone_; i++) {
+            if (strcmp(zone_[i].zone_type, zone_type) == 0) {
+                cooling.zone = i;
+            }
+        }
+        cooling.trip = value.get("Trip", 0).asInt();
+        cooling.max_state = value.get("MaxState", 1).asInt();
+        cooling.power_reduction = value.get("PowerReduction", 0.5).asFloat();
+        cooling.state = 0;
+        if (cooling.zone < 0 || cooling.trip < 0 || cooling.trip >= zone_[cooling.zone].nb_trip ||
+            cooling.max_state <= 0 || cooling.power_reduction < 0 || cooling.power_reduction > 1) {
+            LOG(ERROR) << "SimulatedSource: invalid binding for cooling device " << cooling.cooling_type;
+            return false;
+        }
+        nb_cooling_++;
+    }
+
+    LOG(INFO) << "SimulatedSource: " << nb_zone_ << " zones, " << nb_cooling_ << " cooling devices from " << path;
+    return true;
+}
+
+ssize_t SimulatedSource::readZoneTemp(int zone_id, float *raw) {
+    if (zone_id < 0 || zone_id >= nb_zone_) {
+        return -ENOENT;
+    }
+    *raw = zone_[zone_id].temperature / temperature_mult_;
+    return 0;
+}
+
+ssize_t SimulatedSource::readCoolingState(int cooling_id, float *state) {
+    if (cooling_id < 0 || cooling_id >= nb_cooling_) {
+        return -ENOENT;
+    }
+    *state = cooling_[cooling_id].state;
+    return 0;
+}
+
+/**
+ * Advance virtual clock by a polling period, cooling devices being updated
+ * as the kernel governor would at its own polling
+ *
+ * @return virtual elapsed realtime of the sample, in ns
+ */
+int64_t SimulatedSource::getTimestamp() {
+    advance(step_ns_);
+    govern();
+    return now_;
+}
+
+bool SimulatedSource::getTopology(thermal_topology_t *topology, int (*trip_raw)[kMaxThermalTrip]) {
+    memset(topology, 0, sizeof(thermal_topology_t));
+    for (int i=0; i < nb_zone_; i++) {
+        topology->zone.zone_id[i] = i;
+        strcpy(topology->zone.zone_type[i], zone_[i].zone_type);
+        topology->zone.trip[i].nb_trip = zone_[i].nb_trip;
+        for (int j=0; j < zone_[i].nb_trip; j++) {
+            strcpy(topology->zone.trip[i].trip_type[j], zone_[i].trip_type[j]);
+            trip_raw[i][j] = static_cast<int>(lroundf(zone_[i].trip_temperature[j] / temperature_mult_));
+        }
+    }
+    topology->zone.nb_zone = nb_zone_;
+    for (int j=0; j < nb_cooling_; j++) {
+        topology->cooling.cooling_id[j] = j;
+        strcpy(topology->cooling.cooling_type[j], cooling_[j].cooling_type);
+        topology->cooling.max_state[j] = cooling_[j].max_state;
+    }
+    topology->cooling.nb_cooling = nb_cooling_;
+    return true;
+}
+
+/**
+ * Get back power dissipated in a thermal zone at current virtual time,
+ * scaled down by its cooling devices
+ */
+float SimulatedSource::getPower(int zone_id) const {
+    const sim_zone_t &zone = zone_[zone_id];
+    int64_t offset = now_ % zone.power_period_ns;
+    float watts = zone.power.back().watts;
+
+    for (const sim_power_step_t &step : zone.power) {
+        if (offset < step.duration_ns) {
+            watts = step.watts;
+            break;
+        }
+        offset -= step.duration_ns;
+    }
+    for (int j=0; j < nb_cooling_; j++) {
+        if (cooling_[j].zone == zone_id) {
+            watts *= 1 - cooling_[j].power_reduction * cooling_[j].state / cooling_[j].max_state;
+        }
+    }
+    return watts;
+}
+
+/**
+ * Integrate thermal model, power being constant over each substep
+ * (exact solution of the RC cell)
+ *
+ * @param duration_ns Virtual time to advance
+ */
+void SimulatedSource::advance(int64_t duration_ns) {
+    int64_t end = now_ + duration_ns;
+
+    while (now_ < end) {
+        int64_t substep_ns = std::min(kSimulationSubstepNs, end - now_);
+        for (int i=0; i < nb_zone_; i++) {
+            sim_zone_t &zone = zone_[i];
+            float steady = ambient_ + getPower(i) * zone.resistance;
+            float decay = expf(-substep_ns / 1e9 / (zone.resistance * zone.capacitance));
+            zone.temperature = steady + (zone.temperature - steady) * decay;
+        }
+        now_ += substep_ns;
+    }
+}
+
+/**
+ * Update cooling device states as the kernel step-wise governor does: one
+ * step up while the trip is exceeded and temperature is not dropping, one
+ * step down once below the trip
+ */
+void SimulatedSource::govern() {
+    for (int j=0; j < nb_cooling_; j++) {
+        sim_cooling_t &cooling = cooling_[j];
+        const sim_zone_t &zone = zone_[cooling.zone];
+        float trip = zone.trip_temperature[cooling.trip];
+        if (zone.temperature >= trip && zone.temperature >= last_temperature_[cooling.zone]) {
+            cooling.state = std::min(cooling.state + 1, cooling.max_state);
+        } else if (zone.temperature < trip) {
+            cooling.state = std::max(cooling.state - 1, 0);
+        }
+    }
+    for (int i=0; i < nb_zone_; i++) {
+        last_temperature_[i] = zone_[i].temperature;
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
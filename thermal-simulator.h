@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_SIMULATOR_H__
+#define __THERMAL_SIMULATOR_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "thermal-source.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Integration step of the thermal model, in ns
+constexpr int64_t kSimulationSubstepNs = 10000000;
+
+// Default ambient temperature, in Celsius
+constexpr float kSimulationAmbient = 25.0;
+
+// Power dissipated in a thermal zone during a given time, in W
+struct sim_power_step_t {
+    int64_t             duration_ns;
+    float               watts;
+};
+
+// Thermal zone modelled as a single RC cell to ambient
+struct sim_zone_t {
+    char                zone_type[32];
+    float               resistance;     // to ambient, in K/W
+    float               capacitance;    // in J/K
+    float               temperature;    // in Celsius
+    int                 nb_trip;
+    char                trip_type[kMaxThermalTrip][32];
+    float               trip_temperature[kMaxThermalTrip];
+    std::vector<sim_power_step_t> power;   // repeated
+    int64_t             power_period_ns;
+};
+
+// Cooling device scaling down power of a thermal zone, driven by a step-wise
+// governor on one of its trips, as the kernel does
+struct sim_cooling_t {
+    char                cooling_type[32];
+    int                 zone;           // index in simulated zones
+    int                 trip;           // index in zone trips
+    int                 max_state;
+    float               power_reduction;    // at max state
+    int                 state;
+};
+
+// Thermal zones and cooling devices simulated on a virtual clock, advanced
+// by a polling period at each sample: hours of behavior run in seconds.
+// Thermal zones and cooling devices are indexed as sysfs would.
+class SimulatedSource : public ThermalSource {
+  public:
+    SimulatedSource();
+
+    bool load(const std::string &path, const thermal_config_t &config);
+
+    ssize_t readZoneTemp(int zone_id, float *raw) override;
+    ssize_t readCoolingState(int cooling_id, float *state) override;
+    int64_t getTimestamp() override;
+    bool getTopology(thermal_topology_t *topology, int (*trip_raw)[kMaxThermalTrip]) override;
+
+  private:
+    float getPower(int zone_id) const;
+    void advance(int64_t duration_ns);
+    void govern();
+
+    float ambient_;
+    float temperature_mult_;
+    int64_t step_ns_;
+    int64_t now_;               // virtual elapsed realtime
+    int nb_zone_;
+    sim_zone_t zone_[kMaxThermalZones];
+    float last_temperature_[kMaxThermalZones];
+    int nb_cooling_;
+    sim_cooling_t cooling_[kMaxCoolingDevices];
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_SIMULATOR_H__
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <thread>
+
+#include <android-base/logging.h>
+#include <utils/SystemClock.h>
+
+#include "thermal-source.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::unique_fd;
+
+// Number of records buffered before being written to the trace
+constexpr size_t kTraceBufferRecords = 256;
+
+/**
+ * Read a float from a sysfs file
+ *
+ * @param file_name Path of the file
+ * @param out Pointer to value read
+ *
+ * @return 0 on success or negative value -errno on error.
+ */
+static ssize_t readFloat(const char *file_name, float *out) {
+    FILE *file;
+    float value;
+
+    file = fopen(file_name, "r");
+    if (file == NULL) {
+        PLOG(ERROR) << "readFloat: failed to open file (" << file_name << ")";
+        return -errno;
+    }
+    if (1 != fscanf(file, "%f", &value)) {
+        fclose(file);
+        PLOG(ERROR) << "readFloat: failed to read a float (" << file_name << ")";
+        return errno ? -errno : -EIO;
+    }
+
+    fclose(file);
+
+    *out = value;
+
+    return 0;
+}
+
+ssize_t SysfsSource::readZoneTemp(int zone_id, float *raw) {
+    char file_name[PATH_MAX];
+
+    sprintf(file_name, kThermalZoneTempFileFormat, zone_id);
+    return readFloat(file_name, raw);
+}
+
+ssize_t SysfsSource::readCoolingState(int cooling_id, float *state) {
+    char file_name[PATH_MAX];
+
+    sprintf(file_name, kCoolingDeviceCurStateFileFormat, cooling_id);
+    return readFloat(file_name, state);
+}
+
+int64_t SysfsSource::getTimestamp() {
+    return elapsedRealtimeNano();
+}
+
+RecordingSource::RecordingSource(std::shared_ptr<ThermalSource> source, unique_fd fd)
+    : source_(source),
+      fd_(std::move(fd)),
+      timestamp_(0),
+      nb_record_(0) {
+    buffer_.reserve(kTraceBufferRecords);
+}
+
+RecordingSource::~RecordingSource() {
+    flush();
+    if (fsync(fd_) < 0) {
+        PLOG(WARNING) << "RecordingSource: failed to sync trace";
+    }
+}
+
+ssize_t RecordingSource::readZoneTemp(int zone_id, float *raw) {
+    ssize_t res = source_->readZoneTemp(zone_id, raw);
+
+    record(TraceSource::ZONE_TEMP, zone_id, res, res < 0 ? 0 : *raw);
+    return res;
+}
+
+ssize_t RecordingSource::readCoolingState(int cooling_id, float *state) {
+    ssize_t res = source_->readCoolingState(cooling_id, state);
+
+    record(TraceSource::COOLING_STATE, cooling_id, res, res < 0 ? 0 : *state);
+    return res;
+}
+
+int64_t RecordingSource::getTimestamp() {
+    timestamp_ = source_->getTimestamp();
+    return timestamp_;
+}
+
+/**
+ * Append a read to the trace
+ *
+ * @param source Kind of read
+ * @param id Sysfs index
+ * @param res Result of the read
+ * @param raw Value read, ignored on error
+ */
+void RecordingSource::record(TraceSource source, int id, ssize_t res, float raw) {
+    trace_record_t record = {};
+
+    // Reads of a sample share its timestamp
+    record.timestamp = timestamp_;
+    record.source = static_cast<uint8_t>(source);
+    record.error = static_cast<uint8_t>(res < 0 ? std::min<ssize_t>(-res, UINT8_MAX) : 0);
+    record.id = static_cast<uint16_t>(id);
+    record.raw = raw;
+    buffer_.push_back(record);
+    nb_record_++;
+
+    if (buffer_.size() >= kTraceBufferRecords) {
+        flush();
+    }
+}
+
+/**
+ * Write buffered records to the trace
+ */
+void RecordingSource::flush() {
+    size_t size = buffer_.size() * sizeof(trace_record_t);
+
+    if (size > 0 && TEMP_FAILURE_RETRY(write(fd_, buffer_.data(), size)) != size) {
+        PLOG(ERROR) << "RecordingSource: failed to write trace";
+    }
+    buffer_.clear();
+}
+
+ReplaySource::ReplaySource(bool realtime)
+    : realtime_(realtime),
+      start_(0),
+      header_(),
+      next_(0),
+      mismatch_(false) {}
+
+/**
+ * Load a trace
+ *
+ * @param path Path of the trace
+ * @param config_checksum Checksum of the board configuration to be replayed with
+ *
+ * @return true on success or false if trace is invalid or was recorded with another configuration.
+ */
+bool ReplaySource::open(const std::string &path, uint32_t config_checksum) {
+    struct stat st;
+
+    unique_fd fd(TEMP_FAILURE_RETRY(::open(path.c_str(), O_RDONLY | O_CLOEXEC)));
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        PLOG(ERROR) << "ReplaySource: failed to open trace (" << path << ")";
+        return false;
+    }
+    if (st.st_size < sizeof(trace_header_t) ||
+        TEMP_FAILURE_RETRY(read(fd, &header_, sizeof(header_))) != sizeof(header_) ||
+        header_.magic != kTraceMagic || header_.version != kTraceVersion ||
+        header_.topology_size != sizeof(thermal_topology_t)) {
+        LOG(ERROR) << "ReplaySource: invalid trace (" << path << ")";
+        return false;
+    }
+    if (header_.config_checksum != config_checksum) {
+        LOG(ERROR) << "ReplaySource: trace recorded with another configuration (" << path << ")";
+        return false;
+    }
+
+    // A record truncated by a crash is dropped
+    records_.resize((st.st_size - sizeof(trace_header_t)) / sizeof(trace_record_t));
+    size_t size = records_.size() * sizeof(trace_record_t);
+    if (TEMP_FAILURE_RETRY(read(fd, records_.data(), size)) != size) {
+        PLOG(ERROR) << "ReplaySource: failed to read trace (" << path << ")";
+        return false;
+    }
+    next_ = 0;
+    start_ = 0;
+    mismatch_ = false;
+
+    LOG(INFO) << "ReplaySource: " << records_.size() << " reads from " << path;
+    return true;
+}
+
+ssize_t ReplaySource::readZoneTemp(int zone_id, float *raw) {
+    return replay(TraceSource::ZONE_TEMP, zone_id, raw);
+}
+
+ssize_t ReplaySource::readCoolingState(int cooling_id, float *state) {
+    return replay(TraceSource::COOLING_STATE, cooling_id, state);
+}
+
+/**
+ * Get back timestamp of next sample, waiting for it in real time mode
+ *
+ * @return recorded timestamp
+ */
+int64_t ReplaySource::getTimestamp() {
+    if (done()) {
+        return records_.empty() ? 0 : records_.back().timestamp;
+    }
+
+    int64_t timestamp = records_[next_].timestamp;
+    if (realtime_) {
+        if (start_ == 0) {
+            start_ = elapsedRealtimeNano() - (timestamp - records_[0].timestamp);
+        }
+        int64_t delay = start_ + (timestamp - records_[0].timestamp) - elapsedRealtimeNano();
+        if (delay > 0) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(delay));
+        }
+    }
+    return timestamp;
+}
+
+/**
+ * Get back topology and kernel trip values of the trace
+ */
+bool ReplaySource::getTopology(thermal_topology_t *topology, int (*trip_raw)[kMaxThermalTrip]) {
+    *topology = header_.topology;
+    for (int i=0; i < kMaxThermalZones; i++) {
+        for (int j=0; j < kMaxThermalTrip; j++) {
+            trip_raw[i][j] = header_.trip_raw[i][j];
+        }
+    }
+    return true;
+}
+
+/**
+ * Replay next read
+ *
+ * @param source Kind of read expected
+ * @param id Sysfs index expected
+ * @param raw Pointer to value recorded
+ *
+ * @return 0 on success or negative value -errno on error (recorded, or trace mismatch, ending replay).
+ */
+ssize_t ReplaySource::replay(TraceSource source, int id, float *raw) {
+    if (done()) {
+        return -ENODATA;
+    }
+    const trace_record_t &record = records_[next_];
+    if (record.source != static_cast<uint8_t>(source) || record.id != id) {
+        LOG(ERROR) << "ReplaySource: read " << next_ << " does not match trace";
+        mismatch_ = true;
+        return -EIO;
+    }
+    next_++;
+
+    if (record.error != 0) {
+        return -record.error;
+    }
+    *raw = record.raw;
+    return 0;
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
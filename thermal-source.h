@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_SOURCE_H__
+#define __THERMAL_SOURCE_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <android-base/unique_fd.h>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Source of the reads done at each sample: live sysfs, or a recorded trace
+class ThermalSource {
+  public:
+    virtual ~ThermalSource() = default;
+
+    // Raw thermal zone temperature (kernel unit) and cooling device state, by sysfs index:
+    // 0 on success or negative value -errno on error
+    virtual ssize_t readZoneTemp(int zone_id, float *raw) = 0;
+    virtual ssize_t readCoolingState(int cooling_id, float *state) = 0;
+
+    // Elapsed realtime of the sample about to be read, in ns
+    virtual int64_t getTimestamp() = 0;
+
+    // Thermal zones, cooling devices and kernel trip values the reads are done on, if not
+    // discovered on the platform (sensors being associated by the caller)
+    virtual bool getTopology(thermal_topology_t * /* topology */,
+                             int (* /* trip_raw */)[kMaxThermalTrip]) { return false; }
+};
+
+// Live reads of sysfs thermal class
+class SysfsSource : public ThermalSource {
+  public:
+    ssize_t readZoneTemp(int zone_id, float *raw) override;
+    ssize_t readCoolingState(int cooling_id, float *state) override;
+    int64_t getTimestamp() override;
+};
+
+// Layout of a read trace: a header, holding the topology reads were done
+// on, followed by fixed-size records. Any layout change must bump the version.
+
+constexpr uint32_t kTraceMagic = 0x45435254;   // "TRCE"
+constexpr uint32_t kTraceVersion = 1;
+
+enum class TraceSource : uint8_t {
+    ZONE_TEMP,
+    COOLING_STATE,
+};
+
+struct trace_header_t {
+    uint32_t            magic;
+    uint32_t            version;
+    uint32_t            config_checksum;    // board configuration reads were done with
+    uint32_t            topology_size;      // depends on board profile
+    thermal_topology_t  topology;
+    int32_t             trip_raw[kMaxThermalZones][kMaxThermalTrip];
+};
+
+struct trace_record_t {
+    int64_t             timestamp;      // elapsed realtime in ns
+    uint8_t             source;         // TraceSource
+    uint8_t             error;          // errno, 0 on success
+    uint16_t            id;             // sysfs index
+    float               raw;            // value read, kernel unit
+};
+
+static_assert(sizeof(trace_record_t) == 16, "trace layout must not depend on the build");
+
+// Records all reads of another source to a trace file. Records are
+// buffered, and written by batch.
+class RecordingSource : public ThermalSource {
+  public:
+    RecordingSource(std::shared_ptr<ThermalSource> source, android::base::unique_fd fd);
+    ~RecordingSource();
+
+    ssize_t readZoneTemp(int zone_id, float *raw) override;
+    ssize_t readCoolingState(int cooling_id, float *state) override;
+    int64_t getTimestamp() override;
+
+    std::shared_ptr<ThermalSource> getSource() const { return source_; }
+    size_t getRecordCount() const { return nb_record_; }
+
+  private:
+    void record(TraceSource source, int id, ssize_t res, float raw);
+    void flush();
+
+    std::shared_ptr<ThermalSource> source_;
+    android::base::unique_fd fd_;
+    int64_t timestamp_;
+    std::vector<trace_record_t> buffer_;
+    size_t nb_record_;
+};
+
+// Replays a trace, in the order reads were recorded: as fast as possible,
+// or at the pace they were recorded. A read not matching the next record
+// (other configuration or topology) fails.
+class ReplaySource : public ThermalSource {
+  public:
+    explicit ReplaySource(bool realtime);
+
+    bool open(const std::string &path, uint32_t config_checksum);
+    bool done() const { return mismatch_ || next_ >= records_.size(); }
+
+    ssize_t readZoneTemp(int zone_id, float *raw) override;
+    ssize_t readCoolingState(int cooling_id, float *state) override;
+    int64_t getTimestamp() override;
+    bool getTopology(thermal_topology_t *topology, int (*trip_raw)[kMaxThermalTrip]) override;
+
+  private:
+    ssize_t replay(TraceSource source, int id, float *raw);
+
+    bool realtime_;
+    int64_t start_;             // elapsed realtime the replay started at
+    trace_header_t header_;
+    std::vector<trace_record_t> records_;
+    size_t next_;
+    bool mismatch_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_SOURCE_H__
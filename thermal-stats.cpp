@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <utils/SystemClock.h>
+
+#include "thermal-stats.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+static_assert(kStatsWindowNs[0] < kStatsWindowNs[1] && kStatsWindowNs[1] < kStatsWindowNs[2],
+              "windows must be sorted, shortest first");
+
+/**
+ * Get back histogram bucket of a temperature
+ *
+ * @return bucket index
+ */
+static int getBucket(float value) {
+    int bucket = static_cast<int>(std::floor((value - kStatsMinTemperature) / kStatsResolution));
+
+    return std::clamp(bucket, 0, kStatsBucketNum - 1);
+}
+
+/**
+ * Add a sample to all windows of a sensor
+ *
+ * @param sensor Sensor statistics
+ * @param sample New sample, newer than all samples of the sensor
+ */
+void StatsCollector::add(sensor_stats_t *sensor, const stats_sample_t &sample) {
+    sensor->history.push_back(sample);
+
+    for (int w=0; w < kStatsWindowNum; w++) {
+        window_stats_t &window = sensor->window[w];
+        window.count++;
+        window.sum += sample.value;
+        window.histogram[getBucket(sample.value)]++;
+
+        // Samples dominated by the new one can't be min (or max) any more
+        while (!window.min.empty() && window.min.back().value >= sample.value) {
+            window.min.pop_back();
+        }
+        window.min.push_back(sample);
+        while (!window.max.empty() && window.max.back().value <= sample.value) {
+            window.max.pop_back();
+        }
+        window.max.push_back(sample);
+    }
+}
+
+/**
+ * Remove samples out of windows of a sensor
+ *
+ * @param sensor Sensor statistics
+ * @param now Timestamp of last sample, in ns
+ */
+void StatsCollector::expire(sensor_stats_t *sensor, int64_t now) {
+    for (int w=0; w < kStatsWindowNum; w++) {
+        window_stats_t &window = sensor->window[w];
+        int64_t oldest = now - kStatsWindowNs[w];
+
+        while (window.count > 0) {
+            const stats_sample_t &sample = sensor->history[sensor->history.size() - window.count];
+            if (sample.timestamp > oldest) {
+                break;
+            }
+            window.count--;
+            window.sum -= sample.value;
+            window.histogram[getBucket(sample.value)]--;
+        }
+        while (!window.min.empty() && window.min.front().timestamp <= oldest) {
+            window.min.pop_front();
+        }
+        while (!window.max.empty() && window.max.front().timestamp <= oldest) {
+            window.max.pop_front();
+        }
+    }
+
+    // History only holds samples of the longest window
+    while (sensor->history.size() > sensor->window[kStatsWindowNum - 1].count) {
+        sensor->history.pop_front();
+    }
+}
+
+/**
+ * Estimate a percentile from the histogram of a window
+ *
+ * @param window Window statistics, not empty
+ * @param percentile Percentile, 0 to 1
+ *
+ * @return middle of the bucket holding the percentile, within window min and max
+ */
+float StatsCollector::getPercentile(const window_stats_t &window, float percentile) {
+    size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(percentile * window.count)));
+    size_t count = 0;
+    int bucket = 0;
+
+    for (bucket=0; bucket < kStatsBucketNum - 1; bucket++) {
+        count += window.histogram[bucket];
+        if (count >= rank) {
+            break;
+        }
+    }
+
+    float value = kStatsMinTemperature + (bucket + 0.5) * kStatsResolution;
+    return std::clamp(value, window.min.front().value, window.max.front().value);
+}
+
+/**
+ * Add a periodic sample to statistics of its sensors
+ *
+ * @param snapshot New sample, newer than all previous ones
+ */
+void StatsCollector::update(const thermal_snapshot_t &snapshot) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        if (!std::isfinite(sample.value)) {
+            continue;
+        }
+        const sensor_config_t &config = snapshot.config->sensor[sample.name];
+        sensor_stats_t &sensor = sensors_[config.name];
+        sensor.type = config.type;
+        add(&sensor, {snapshot.timestamp, sample.value});
+    }
+
+    // Sensors no longer sampled are dropped once out of all windows
+    for (auto sensor = sensors_.begin(); sensor != sensors_.end();) {
+        expire(&sensor->second, snapshot.timestamp);
+        if (sensor->second.history.empty()) {
+            sensor = sensors_.erase(sensor);
+        } else {
+            sensor++;
+        }
+    }
+}
+
+/**
+ * Get back statistics of sensors
+ *
+ * @param filter_type true if only sensors of type are returned
+ * @param type Temperature type, if filter_type
+ * @param stats Pointer to statistics, sorted by sensor name
+ */
+void StatsCollector::getStats(bool filter_type, TemperatureType type, hidl_vec<TemperatureStats> *stats) {
+    std::vector<TemperatureStats> result;
+    int64_t now = elapsedRealtimeNano();
+
+    {
+        std::lock_guard<std::mutex> _lock(mutex_);
+
+        for (auto &entry : sensors_) {
+            sensor_stats_t &sensor = entry.second;
+            if (filter_type && sensor.type != type) {
+                continue;
+            }
+            // Windows are only expired by samples, which stop with periodic sampling
+            expire(&sensor, now);
+
+            TemperatureStats &sensor_stats = result.emplace_back();
+            sensor_stats.name = entry.first;
+            sensor_stats.type = sensor.type;
+            sensor_stats.windows.resize(kStatsWindowNum);
+            for (int w=0; w < kStatsWindowNum; w++) {
+                const window_stats_t &window = sensor.window[w];
+                TemperatureWindowStats &out = sensor_stats.windows[w];
+                out.windowMs = kStatsWindowNs[w] / 1000000;
+                out.count = window.count;
+                if (window.count == 0) {
+                    out.min = out.max = out.mean = out.p50 = out.p90 = out.p99 = NAN;
+                    continue;
+                }
+                out.min = window.min.front().value;
+                out.max = window.max.front().value;
+                out.mean = window.sum / window.count;
+                out.p50 = getPercentile(window, 0.50);
+                out.p90 = getPercentile(window, 0.90);
+                out.p99 = getPercentile(window, 0.99);
+            }
+        }
+    }
+
+    *stats = result;
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
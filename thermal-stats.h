@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_STATS_H__
+#define __THERMAL_STATS_H__
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <vendor/stm32mpu/hardware/thermal/1.0/types.h>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::vendor::stm32mpu::hardware::thermal::V1_0::TemperatureStats;
+using ::vendor::stm32mpu::hardware::thermal::V1_0::TemperatureWindowStats;
+
+// Sliding windows, shortest first: 10 s, 1 min, 10 min
+constexpr int kStatsWindowNum = 3;
+constexpr int64_t kStatsWindowNs[kStatsWindowNum] = {10000000000LL, 60000000000LL, 600000000000LL};
+
+// Percentile histogram: kStatsResolution wide buckets from kStatsMinTemperature
+// to kStatsMaxTemperature, values out of range being counted in first or last bucket
+constexpr float kStatsMinTemperature = -40.0;
+constexpr float kStatsMaxTemperature = 150.0;
+constexpr float kStatsResolution = 0.5;
+constexpr int kStatsBucketNum =
+    static_cast<int>((kStatsMaxTemperature - kStatsMinTemperature) / kStatsResolution);
+
+// Running statistics of sensors over sliding windows. Each sample is added
+// and removed once per window: min and max are kept by monotonic deques,
+// mean by a running sum and percentiles by a histogram.
+class StatsCollector {
+  public:
+    StatsCollector() = default;
+
+    void update(const thermal_snapshot_t &snapshot);
+    void getStats(bool filter_type, TemperatureType type, hidl_vec<TemperatureStats> *stats);
+
+  private:
+    struct stats_sample_t {
+        int64_t     timestamp;
+        float       value;
+    };
+
+    struct window_stats_t {
+        size_t                      count;      // last samples of sensor history in window
+        double                      sum;
+        std::deque<stats_sample_t>  min;        // increasing values
+        std::deque<stats_sample_t>  max;        // decreasing values
+        uint16_t                    histogram[kStatsBucketNum];
+    };
+
+    struct sensor_stats_t {
+        TemperatureType             type;
+        std::deque<stats_sample_t>  history;    // samples of the longest window
+        window_stats_t              window[kStatsWindowNum];
+    };
+
+    static void add(sensor_stats_t *sensor, const stats_sample_t &sample);
+    static void expire(sensor_stats_t *sensor, int64_t now);
+    static float getPercentile(const window_stats_t &window, float percentile);
+
+    std::mutex mutex_;
+    std::map<std::string, sensor_stats_t> sensors_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_STATS_H__
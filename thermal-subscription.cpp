@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <iterator>
+
+#include <android-base/logging.h>
+#include <hidl/HidlBinderSupport.h>
+#include <hidl/HidlTransportSupport.h>
+
+#include "thermal-subscription.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::hardware::interfacesEqual;
+using ::android::hardware::toBinder;
+
+void ThresholdRegistry::DeathRecipient::serviceDied(uint64_t cookie, const wp<IBase> & /* who */) {
+    LOG(WARNING) << "ThermalThresholdCallback died, unregister its thresholds";
+    registry_->removeCookie(cookie);
+}
+
+ThresholdRegistry::ThresholdRegistry() : death_recipient_(new DeathRecipient(this)), next_id_(1) {}
+
+ThresholdRegistry::~ThresholdRegistry() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    // No death notification must reach the registry once destroyed
+    for (const auto &entry : subscriptions_) {
+        if (clients_.erase(entry.second.cookie) != 0) {
+            entry.second.callback->unlinkToDeath(death_recipient_);
+        }
+    }
+}
+
+/**
+ * Get back identity of a callback, same for all proxies of a remote callback
+ *
+ * @param callback Callback
+ *
+ * @return binder address, used as death cookie
+ */
+uint64_t ThresholdRegistry::getCookie(const sp<IThermalThresholdCallback> &callback) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(toBinder<IBase>(callback).get()));
+}
+
+/**
+ * Register a custom threshold
+ *
+ * @param callback Callback to be notified
+ * @param name Name of the sensor
+ * @param threshold Threshold, in Celsius
+ * @param hysteresis Hysteresis applied when temperature falls, in Celsius
+ * @param value Last temperature of the sensor, NAN if unknown (considered below)
+ * @param id Pointer to subscription identifier
+ *
+ * @return true on success or false if too many subscriptions.
+ */
+bool ThresholdRegistry::add(const sp<IThermalThresholdCallback> &callback, const std::string &name,
+                            float threshold, float hysteresis, float value, uint32_t *id) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    if (subscriptions_.size() >= kMaxThresholdSubscriptions) {
+        return false;
+    }
+
+    // Identifiers are not reused before wrapping around
+    while (next_id_ == 0 || subscriptions_.count(next_id_) != 0) {
+        next_id_++;
+    }
+    *id = next_id_++;
+
+    // Client is linked to death once, by its first subscription
+    uint64_t cookie = getCookie(callback);
+    if (clients_[cookie]++ == 0) {
+        Return<bool> linked = callback->linkToDeath(death_recipient_, cookie);
+        if (!linked.isOk() || !linked) {
+            LOG(WARNING) << "Failed to link to death of ThermalThresholdCallback";
+        }
+    }
+
+    subscription_t &subscription = subscriptions_[*id];
+    sensor_index_t &index = sensors_[name];
+    subscription.callback = callback;
+    subscription.cookie = cookie;
+    subscription.name = name;
+    subscription.threshold = threshold;
+    subscription.hysteresis = hysteresis;
+    subscription.above = (value >= threshold);
+    if (subscription.above) {
+        subscription.position = index.above.emplace(threshold - hysteresis, *id);
+    } else {
+        subscription.position = index.below.emplace(threshold, *id);
+    }
+    return true;
+}
+
+/**
+ * Remove a subscription from its sensor index and from its client, mutex_ being held
+ *
+ * @param subscription Subscription to be removed
+ */
+void ThresholdRegistry::erase(const subscription_t &subscription) {
+    auto sensor = sensors_.find(subscription.name);
+    sensor_index_t &index = sensor->second;
+
+    auto client = clients_.find(subscription.cookie);
+    if (--client->second == 0) {
+        subscription.callback->unlinkToDeath(death_recipient_);
+        clients_.erase(client);
+    }
+
+    if (subscription.above) {
+        index.above.erase(subscription.position);
+    } else {
+        index.below.erase(subscription.position);
+    }
+    if (index.above.empty() && index.below.empty()) {
+        sensors_.erase(sensor);
+    }
+}
+
+/**
+ * Unregister a custom threshold
+ *
+ * @param callback Callback used for registration
+ * @param id Subscription identifier
+ *
+ * @return true on success or false if no such subscription for this callback.
+ */
+bool ThresholdRegistry::remove(const sp<IThermalThresholdCallback> &callback, uint32_t id) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    auto subscription = subscriptions_.find(id);
+    if (subscription == subscriptions_.end() ||
+        !interfacesEqual(subscription->second.callback, callback)) {
+        return false;
+    }
+    erase(subscription->second);
+    subscriptions_.erase(subscription);
+    return true;
+}
+
+/**
+ * Get back number of custom thresholds
+ *
+ * @return number of subscriptions
+ */
+size_t ThresholdRegistry::size() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    return subscriptions_.size();
+}
+
+/**
+ * Unregister all custom thresholds of a callback (client died)
+ *
+ * @param callback Callback used for registration
+ */
+void ThresholdRegistry::removeCallback(const sp<IThermalThresholdCallback> &callback) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    for (auto subscription = subscriptions_.begin(); subscription != subscriptions_.end();) {
+        if (interfacesEqual(subscription->second.callback, callback)) {
+            erase(subscription->second);
+            subscription = subscriptions_.erase(subscription);
+        } else {
+            subscription++;
+        }
+    }
+}
+
+/**
+ * Unregister all custom thresholds of a dead client
+ *
+ * @param cookie Identity of the callback
+ */
+void ThresholdRegistry::removeCookie(uint64_t cookie) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    for (auto subscription = subscriptions_.begin(); subscription != subscriptions_.end();) {
+        if (subscription->second.cookie == cookie) {
+            erase(subscription->second);
+            subscription = subscriptions_.erase(subscription);
+        } else {
+            subscription++;
+        }
+    }
+}
+
+/**
+ * Check custom thresholds against a new sample
+ *
+ * Only the lowest boundary of subscriptions below and the highest boundary
+ * of subscriptions above are compared, other ones being checked only while
+ * they are crossed.
+ *
+ * @param snapshot New sample
+ * @param notifications Pointer to crossings to be sent, once the registry is unlocked
+ */
+void ThresholdRegistry::update(const thermal_snapshot_t &snapshot,
+                               std::vector<threshold_notification_t> *notifications) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    if (sensors_.empty()) {
+        return;
+    }
+
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        auto sensor = sensors_.find(snapshot.config->sensor[sample.name].name);
+        if (sensor == sensors_.end()) {
+            continue;
+        }
+        sensor_index_t &index = sensor->second;
+
+        // Rising: lowest thresholds first, until one is above temperature
+        while (!index.below.empty() && index.below.begin()->first <= sample.value) {
+            uint32_t id = index.below.begin()->second;
+            subscription_t &subscription = subscriptions_[id];
+            index.below.erase(index.below.begin());
+            subscription.above = true;
+            subscription.position = index.above.emplace(subscription.threshold - subscription.hysteresis, id);
+            notifications->push_back({subscription.callback,
+                                      {id, sensor->first, subscription.threshold, sample.value,
+                                       ThresholdDirection::RISING, snapshot.timestamp}});
+        }
+
+        // Falling: highest boundaries first, until one is not above temperature
+        while (!index.above.empty() && std::prev(index.above.end())->first > sample.value) {
+            auto last = std::prev(index.above.end());
+            uint32_t id = last->second;
+            subscription_t &subscription = subscriptions_[id];
+            index.above.erase(last);
+            subscription.above = false;
+            subscription.position = index.below.emplace(subscription.threshold, id);
+            notifications->push_back({subscription.callback,
+                                      {id, sensor->first, subscription.threshold, sample.value,
+                                       ThresholdDirection::FALLING, snapshot.timestamp}});
+        }
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
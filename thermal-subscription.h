@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_SUBSCRIPTION_H__
+#define __THERMAL_SUBSCRIPTION_H__
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vendor/stm32mpu/hardware/thermal/1.0/IThermalThresholdCallback.h>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::wp;
+using ::android::hardware::hidl_death_recipient;
+using ::android::hidl::base::V1_0::IBase;
+using ::vendor::stm32mpu::hardware::thermal::V1_0::IThermalThresholdCallback;
+using ::vendor::stm32mpu::hardware::thermal::V1_0::ThresholdDirection;
+using ::vendor::stm32mpu::hardware::thermal::V1_0::ThresholdEvent;
+
+// Maximum number of custom thresholds registered by all clients
+constexpr size_t kMaxThresholdSubscriptions = 256;
+
+// Threshold crossing to be sent to a client
+struct threshold_notification_t {
+    sp<IThermalThresholdCallback>   callback;
+    ThresholdEvent                  event;
+};
+
+// Custom thresholds registered by clients. Subscriptions of a sensor are
+// sorted by the boundary they wait for: threshold when temperature is below,
+// threshold - hysteresis when above. A sample only checks the boundaries
+// adjacent to the previous temperature, whatever the number of subscriptions.
+// All subscriptions of a client are removed as soon as it dies.
+class ThresholdRegistry {
+  public:
+    ThresholdRegistry();
+    ~ThresholdRegistry();
+
+    bool add(const sp<IThermalThresholdCallback> &callback, const std::string &name, float threshold,
+             float hysteresis, float value, uint32_t *id);
+    bool remove(const sp<IThermalThresholdCallback> &callback, uint32_t id);
+    void removeCallback(const sp<IThermalThresholdCallback> &callback);
+    size_t size();
+
+    void update(const thermal_snapshot_t &snapshot, std::vector<threshold_notification_t> *notifications);
+
+  private:
+    class DeathRecipient : public hidl_death_recipient {
+      public:
+        explicit DeathRecipient(ThresholdRegistry *registry) : registry_(registry) {}
+        void serviceDied(uint64_t cookie, const wp<IBase> &who) override;
+
+      private:
+        ThresholdRegistry *registry_;
+    };
+
+    // Boundary to subscription identifier
+    using boundary_map_t = std::multimap<float, uint32_t>;
+
+    struct subscription_t {
+        sp<IThermalThresholdCallback>   callback;
+        uint64_t                        cookie;     // binder of the callback
+        std::string                     name;
+        float                           threshold;
+        float                           hysteresis;
+        bool                            above;      // last crossing was RISING
+        boundary_map_t::iterator        position;   // in below or above map of the sensor
+    };
+
+    struct sensor_index_t {
+        boundary_map_t  below;  // keyed by threshold, all greater than last temperature
+        boundary_map_t  above;  // keyed by threshold - hysteresis, all lower or equal
+    };
+
+    static uint64_t getCookie(const sp<IThermalThresholdCallback> &callback);
+    void erase(const subscription_t &subscription);
+    void removeCookie(uint64_t cookie);
+
+    std::mutex mutex_;
+    sp<DeathRecipient> death_recipient_;
+    uint32_t next_id_;
+    std::unordered_map<uint32_t, subscription_t> subscriptions_;
+    // Binder of the callback (also used as death cookie) to number of subscriptions
+    std::unordered_map<uint64_t, size_t> clients_;
+    std::map<std::string, sensor_index_t> sensors_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_SUBSCRIPTION_H__
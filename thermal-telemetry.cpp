@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+
+#include <sys/mman.h>
+
+#include <android-base/logging.h>
+#include <android-base/unique_fd.h>
+#include <cutils/ashmem.h>
+#include <cutils/native_handle.h>
+
+#include "thermal-helper.h"
+#include "thermal-telemetry.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::unique_fd;
+
+static_assert(kMaxSensors <= kTelemetryMaxTemperatures && kMaxCoolingDevices <= kTelemetryMaxCoolings,
+              "telemetry region too small for sensors and cooling devices");
+
+// Telemetry region, mapped read-write by the service only (set once before sampling starts)
+static thermal_telemetry_t *gTelemetry = nullptr;
+static native_handle_t *gTelemetryHandle = nullptr;
+
+/**
+ * Allocate telemetry shared memory region, read-only for clients
+ *
+ * Must be called before any sampling.
+ *
+ * @return true on success or false on error.
+ */
+bool initTelemetry() {
+    unique_fd fd(ashmem_create_region("thermal-telemetry", sizeof(thermal_telemetry_t)));
+    if (fd < 0) {
+        PLOG(ERROR) << "initTelemetry: failed to create region";
+        return false;
+    }
+
+    void *map = mmap(nullptr, sizeof(thermal_telemetry_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        PLOG(ERROR) << "initTelemetry: failed to map region";
+        return false;
+    }
+    // Mappings done after this point, by clients, can only be read-only
+    if (ashmem_set_prot_region(fd, PROT_READ) < 0) {
+        PLOG(ERROR) << "initTelemetry: failed to protect region";
+        munmap(map, sizeof(thermal_telemetry_t));
+        return false;
+    }
+
+    thermal_telemetry_t *telemetry = static_cast<thermal_telemetry_t *>(map);
+    telemetry->magic = kTelemetryMagic;
+    telemetry->version = kTelemetryVersion;
+    telemetry->sequence.store(0, std::memory_order_relaxed);
+
+    gTelemetryHandle = native_handle_create(1, 0);
+    gTelemetryHandle->data[0] = fd.release();
+    gTelemetry = telemetry;
+    return true;
+}
+
+/**
+ * Publish a snapshot in telemetry region, gSnapshotMutex being held (single writer)
+ *
+ * @param snapshot Snapshot to be published
+ */
+void publishTelemetry(const thermal_snapshot_t &snapshot) {
+    hidl_vec<Temperature_2_0> temperatures;
+    hidl_vec<RawTemperature> raw_temperatures;
+    hidl_vec<CoolingDevice_2_0> cooling_devices;
+    telemetry_data_t data = {};
+
+    if (gTelemetry == nullptr) {
+        return;
+    }
+
+    // Same view as getCurrentTemperatures() and getCurrentCoolingDevices()
+    fillTemperatures(snapshot, false, TemperatureType::UNKNOWN, &temperatures);
+    fillTemperatures(snapshot, false, TemperatureType::UNKNOWN, &raw_temperatures);
+    fillCoolingDevices(snapshot, false, CoolingType_2_0::FAN, &cooling_devices);
+
+    data.timestamp = snapshot.timestamp;
+    data.nb_temperature = std::min<size_t>(temperatures.size(), kTelemetryMaxTemperatures);
+    for (int i=0; i < data.nb_temperature; i++) {
+        telemetry_temperature_t &temperature = data.temperature[i];
+        strncpy(temperature.name, temperatures[i].name.c_str(), sizeof(temperature.name) - 1);
+        temperature.type = static_cast<int32_t>(temperatures[i].type);
+        temperature.value = temperatures[i].value;
+        temperature.severity = static_cast<uint32_t>(temperatures[i].throttlingStatus);
+        temperature.raw_value = raw_temperatures[i].rawValue;
+    }
+    data.nb_cooling = std::min<size_t>(cooling_devices.size(), kTelemetryMaxCoolings);
+    for (int j=0; j < data.nb_cooling; j++) {
+        telemetry_cooling_t &cooling = data.cooling[j];
+        strncpy(cooling.name, cooling_devices[j].name.c_str(), sizeof(cooling.name) - 1);
+        cooling.type = static_cast<uint32_t>(cooling_devices[j].type);
+        cooling.value = cooling_devices[j].value;
+    }
+
+    // Sequence is odd while data is written, readers retry meanwhile
+    uint32_t sequence = gTelemetry->sequence.load(std::memory_order_relaxed);
+    gTelemetry->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&gTelemetry->data, &data, sizeof(telemetry_data_t));
+    gTelemetry->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * Fill telemetry shared memory region
+ *
+ * @param memory Pointer to region
+ *
+ * @return true on success or false if region is not available.
+ */
+bool fillTelemetryMemory(hidl_memory *memory) {
+    if (gTelemetryHandle == nullptr) {
+        return false;
+    }
+    *memory = hidl_memory("ashmem", gTelemetryHandle, sizeof(thermal_telemetry_t));
+    return true;
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_TELEMETRY_H__
+#define __THERMAL_TELEMETRY_H__
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <hidl/HidlSupport.h>
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Layout of the telemetry shared memory region, shared with vendor clients:
+// any layout change must bump the version
+
+constexpr uint32_t kTelemetryMagic = 0x4d4c4554;   // "TELM"
+constexpr uint32_t kTelemetryVersion = 2;
+
+// Capacity of the region, independent of the board profile
+constexpr unsigned int kTelemetryMaxTemperatures = 16;
+constexpr unsigned int kTelemetryMaxCoolings = 8;
+
+struct telemetry_temperature_t {
+    char                name[32];
+    int32_t             type;       // V2_0::TemperatureType
+    float               value;      // Celsius, filtered
+    uint32_t            severity;   // V2_0::ThrottlingSeverity
+    float               raw_value;  // Celsius, before filter
+};
+
+struct telemetry_cooling_t {
+    char                name[32];
+    uint32_t            type;       // V2_0::CoolingType
+    uint64_t            value;
+};
+
+struct telemetry_data_t {
+    int64_t                 timestamp;  // elapsed realtime in ns, 0 until first sample
+    uint32_t                nb_temperature;
+    uint32_t                nb_cooling;
+    telemetry_temperature_t temperature[kTelemetryMaxTemperatures];
+    telemetry_cooling_t     cooling[kTelemetryMaxCoolings];
+};
+
+struct thermal_telemetry_t {
+    uint32_t                magic;
+    uint32_t                version;
+    std::atomic<uint32_t>   sequence;   // odd while data is being written
+    uint32_t                reserved;
+    telemetry_data_t        data;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "telemetry sequence must be lock free to be shared between processes");
+
+/**
+ * Read a consistent copy of telemetry data (client side)
+ *
+ * @param telemetry Shared memory region, mapped read-only
+ * @param out Pointer to data copied
+ */
+inline void readTelemetry(const thermal_telemetry_t &telemetry, telemetry_data_t *out) {
+    uint32_t begin, end;
+
+    do {
+        begin = telemetry.sequence.load(std::memory_order_acquire);
+        memcpy(out, &telemetry.data, sizeof(telemetry_data_t));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        end = telemetry.sequence.load(std::memory_order_relaxed);
+    } while ((begin & 1) || begin != end);
+}
+
+// Service side
+
+struct thermal_snapshot_t;
+
+bool initTelemetry();
+void publishTelemetry(const thermal_snapshot_t &snapshot);
+bool fillTelemetryMemory(hidl_memory *memory);
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_TELEMETRY_H__
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+
+#include "thermal-uclamp.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+using ::android::base::StringAppendF;
+using ::android::base::StringPrintf;
+using ::android::base::WriteStringToFile;
+
+UclampAdvisor::UclampAdvisor()
+    : level_(ThrottlingSeverity::NONE),
+      nb_write_(0),
+      nb_error_(0) {
+    std::fill(severity_, severity_ + kMaxSensors, ThrottlingSeverity::NONE);
+    std::fill(written_, written_ + kMaxUclampGroups, NAN);
+    std::fill(failed_, failed_ + kMaxUclampGroups, false);
+}
+
+UclampAdvisor::~UclampAdvisor() {
+    std::lock_guard<std::mutex> _lock(mutex_);
+    restore();
+}
+
+/**
+ * Write utilization clamp of a configured group
+ *
+ * @param uclamp Advisor configuration
+ * @param group Index of the group in configuration
+ * @param value Percentage, 100 removing the clamp
+ *
+ * @return true on success, false otherwise.
+ */
+bool UclampAdvisor::write(const uclamp_config_t &uclamp, int group, float value) {
+    std::string path = StringPrintf("%s/%s/%s", uclamp.root, uclamp.group[group].path, kUclampMaxFile);
+    std::string content = value >= 100 ? "max" : StringPrintf("%.2f", value);
+
+    nb_write_++;
+    if (!WriteStringToFile(content, path)) {
+        nb_error_++;
+        // Logged once until the group can be written again
+        if (!failed_[group]) {
+            PLOG(ERROR) << "UclampAdvisor: failed to write " << content << " to " << path;
+            failed_[group] = true;
+        }
+        return false;
+    }
+    failed_[group] = false;
+    return true;
+}
+
+/**
+ * Remove clamps written with current configuration
+ */
+void UclampAdvisor::restore() {
+    if (config_ == nullptr) {
+        return;
+    }
+    for (int g=0; g < config_->uclamp.nb_group; g++) {
+        if (!std::isnan(written_[g]) && written_[g] < 100) {
+            write(config_->uclamp, g, 100);
+        }
+        written_[g] = NAN;
+        failed_[g] = false;
+    }
+}
+
+/**
+ * Update clamps from a periodic sample
+ *
+ * @param snapshot New sample
+ */
+void UclampAdvisor::update(const thermal_snapshot_t &snapshot) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    // Clamps of previous configuration are removed, as its groups may not be configured anymore
+    if (config_ != snapshot.config) {
+        restore();
+        config_ = snapshot.config;
+        std::fill(severity_, severity_ + kMaxSensors, ThrottlingSeverity::NONE);
+        level_ = ThrottlingSeverity::NONE;
+    }
+
+    const uclamp_config_t &uclamp = config_->uclamp;
+    if (uclamp.nb_group == 0) {
+        return;
+    }
+
+    level_ = ThrottlingSeverity::NONE;
+    for (int i=0; i < snapshot.nb_temperature; i++) {
+        const temperature_sample_t &sample = snapshot.temperature[i];
+        severity_[sample.name] = getSeverity(snapshot.thresholds->all[sample.sensor], sample.value,
+                                             severity_[sample.name], uclamp.hysteresis);
+        level_ = std::max(level_, severity_[sample.name]);
+    }
+
+    // Groups are only written on change, or until a write succeeds
+    for (int g=0; g < uclamp.nb_group; g++) {
+        float value = uclamp.group[g].uclamp_max[static_cast<int>(level_)];
+        if (value == written_[g]) {
+            continue;
+        }
+        if (write(uclamp, g, value)) {
+            written_[g] = value;
+        }
+    }
+}
+
+/**
+ * Dump advisor state
+ *
+ * @param out Pointer to dump
+ */
+void UclampAdvisor::dump(std::string *out) {
+    std::lock_guard<std::mutex> _lock(mutex_);
+
+    if (config_ == nullptr || config_->uclamp.nb_group == 0) {
+        return;
+    }
+    StringAppendF(out, "Uclamp: severity %d, %u writes, %u errors", static_cast<int>(level_), nb_write_,
+                  nb_error_);
+    for (int g=0; g < config_->uclamp.nb_group; g++) {
+        StringAppendF(out, ", %s: %.2f", config_->uclamp.group[g].path, written_[g]);
+    }
+    *out += "\n";
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_UCLAMP_H__
+#define __THERMAL_UCLAMP_H__
+
+#include <mutex>
+#include <string>
+
+#include "thermal-helper.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Utilization clamp file of a cgroup, relative to its directory
+constexpr const char *kUclampMaxFile = "cpu.uclamp.max";
+
+// Soft cooling actuator: caps utilization of configured cgroups (background,
+// top-app...) as severity climbs, so that their work is pushed down before
+// kernel cooling devices engage. Severity is the highest of all sensors, each
+// one leaving a severity only once its temperature went below the threshold
+// minus the configured hysteresis.
+class UclampAdvisor {
+  public:
+    UclampAdvisor();
+    ~UclampAdvisor();
+
+    void update(const thermal_snapshot_t &snapshot);
+    void dump(std::string *out);
+
+  private:
+    bool write(const uclamp_config_t &uclamp, int group, float value);
+    void restore();
+
+    std::mutex mutex_;
+    // Severity of configured sensors, with hysteresis, reset by a new configuration
+    std::shared_ptr<const thermal_config_t> config_;
+    ThrottlingSeverity severity_[kMaxSensors];
+    ThrottlingSeverity level_;
+
+    // Value written to each configured group, NAN if none yet
+    float written_[kMaxUclampGroups];
+    bool failed_[kMaxUclampGroups];
+    uint32_t nb_write_;
+    uint32_t nb_error_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_UCLAMP_H__
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <android-base/logging.h>
+#include <cutils/uevent.h>
+
+#include "thermal-uevent.h"
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Size of uevent socket receive buffer
+constexpr int kUeventSocketBufferSize = 64 * 1024;
+
+// Maximum size of a uevent message
+constexpr size_t kUeventMsgSize = 2048;
+
+UeventListener::UeventListener(std::function<void()> callback) : callback_(callback) {}
+
+UeventListener::~UeventListener() {
+    if (thread_.joinable()) {
+        uint64_t value = 1;
+        if (write(stop_fd_, &value, sizeof(value)) != sizeof(value)) {
+            PLOG(ERROR) << "UeventListener: failed to stop";
+        }
+        thread_.join();
+    }
+}
+
+/**
+ * Open uevent socket and start listening
+ *
+ * @return true on success or false on error.
+ */
+bool UeventListener::start() {
+    uevent_fd_.reset(uevent_open_socket(kUeventSocketBufferSize, true));
+    if (uevent_fd_ < 0) {
+        PLOG(ERROR) << "UeventListener: failed to open uevent socket";
+        return false;
+    }
+    stop_fd_.reset(eventfd(0, EFD_CLOEXEC));
+    if (stop_fd_ < 0) {
+        PLOG(ERROR) << "UeventListener: failed to create eventfd";
+        return false;
+    }
+
+    thread_ = std::thread(&UeventListener::listenLoop, this);
+    return true;
+}
+
+void UeventListener::listenLoop() {
+    char msg[kUeventMsgSize + 2];
+    struct pollfd fds[] = {
+        {.fd = uevent_fd_, .events = POLLIN},
+        {.fd = stop_fd_, .events = POLLIN},
+    };
+
+    while (true) {
+        if (TEMP_FAILURE_RETRY(poll(fds, 2, -1)) < 0) {
+            PLOG(ERROR) << "UeventListener: poll failed";
+            return;
+        }
+        if (fds[1].revents) {
+            return;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        // Messages not sent by the kernel are dropped
+        ssize_t len = uevent_kernel_multicast_recv(uevent_fd_, msg, kUeventMsgSize);
+        if (len <= 0 || len > kUeventMsgSize) {
+            continue;
+        }
+        msg[len] = '\0';
+        msg[len + 1] = '\0';
+
+        // Message is "action@devpath" followed by "KEY=value" strings
+        bool thermal = false;
+        bool hotplug = false;
+        for (const char *cp = msg; *cp != '\0'; cp += strlen(cp) + 1) {
+            if (strcmp(cp, "SUBSYSTEM=thermal") == 0) {
+                thermal = true;
+            } else if (strcmp(cp, "ACTION=add") == 0 || strcmp(cp, "ACTION=remove") == 0) {
+                hotplug = true;
+            }
+        }
+
+        if (thermal && hotplug) {
+            LOG(INFO) << "UeventListener: " << msg;
+            callback_();
+        }
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 STMicroelectronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THERMAL_UEVENT_H__
+#define __THERMAL_UEVENT_H__
+
+#include <functional>
+#include <thread>
+
+#include <android-base/unique_fd.h>
+
+namespace android {
+namespace hardware {
+namespace thermal {
+namespace V2_0 {
+namespace implementation {
+
+// Listens to kernel uevents of the thermal subsystem, and reports thermal
+// zones and cooling devices being added or removed.
+class UeventListener {
+  public:
+    explicit UeventListener(std::function<void()> callback);
+    ~UeventListener();
+
+    bool start();
+
+  private:
+    void listenLoop();
+
+    std::function<void()> callback_;
+    android::base::unique_fd uevent_fd_;
+    android::base::unique_fd stop_fd_;
+    std::thread thread_;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace thermal
+}  // namespace hardware
+}  // namespace android
+
+#endif //__THERMAL_UEVENT_H__